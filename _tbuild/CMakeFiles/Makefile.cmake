@@ -0,0 +1,82 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeASMCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/root/repo/cmake/FindGMP.cmake"
+  "/root/repo/test/CMakeLists.txt"
+  "/usr/share/cmake-3.25/Modules/CMakeASMInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-ASM.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPkgConfig.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "test/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "CMakeFiles/mcl.dir/DependInfo.cmake"
+  "CMakeFiles/mcl_st.dir/DependInfo.cmake"
+  "CMakeFiles/mclbn256.dir/DependInfo.cmake"
+  "CMakeFiles/mclbn384.dir/DependInfo.cmake"
+  "CMakeFiles/mclbn384_256.dir/DependInfo.cmake"
+  "test/CMakeFiles/fp_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/ec_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/fp_util_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/window_method_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/elgamal_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/bls12_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/fp_tower_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/gmp_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/bn_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/glv_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/g2_cache_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/thread_pool_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/bn_c256_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/bn_c384_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/bn_c384_256_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/bint_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/vint_test.dir/DependInfo.cmake"
+  )
@@ -0,0 +1,39 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  "ASM"
+  )
+# The set of files for implicit dependencies of each language:
+set(CMAKE_DEPENDS_CHECK_ASM
+  "/root/repo/src/asm/bint-x64-amd64.s" "/root/repo/_tbuild/CMakeFiles/mcl.dir/src/asm/bint-x64-amd64.s.o"
+  "/root/repo/src/asm/x86-64.s" "/root/repo/_tbuild/CMakeFiles/mcl.dir/src/asm/x86-64.s.o"
+  )
+set(CMAKE_ASM_COMPILER_ID "GNU")
+
+# Preprocessor definitions for this target.
+set(CMAKE_TARGET_DEFINITIONS_ASM
+  "MCLBN_NO_AUTOLINK"
+  "MCL_NO_AUTOLINK"
+  "MCL_USE_LLVM=1"
+  "MCL_USE_STD_THREAD"
+  )
+
+# The include file search paths:
+set(CMAKE_ASM_TARGET_INCLUDE_PATH
+  "/root/repo/include"
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/fp.cpp" "CMakeFiles/mcl.dir/src/fp.cpp.o" "gcc" "CMakeFiles/mcl.dir/src/fp.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
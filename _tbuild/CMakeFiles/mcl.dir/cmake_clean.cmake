@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mcl.dir/src/asm/bint-x64-amd64.s.o"
+  "CMakeFiles/mcl.dir/src/asm/x86-64.s.o"
+  "CMakeFiles/mcl.dir/src/fp.cpp.o"
+  "CMakeFiles/mcl.dir/src/fp.cpp.o.d"
+  "lib/libmcl.a"
+  "lib/libmcl.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang ASM CXX)
+  include(CMakeFiles/mcl.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mclbn256.dir/src/bn_c256.cpp.o"
+  "CMakeFiles/mclbn256.dir/src/bn_c256.cpp.o.d"
+  "lib/libmclbn256.a"
+  "lib/libmclbn256.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/mclbn256.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mclbn384.dir/src/bn_c384.cpp.o"
+  "CMakeFiles/mclbn384.dir/src/bn_c384.cpp.o.d"
+  "lib/libmclbn384.a"
+  "lib/libmclbn384.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/mclbn384.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mclbn384_256.dir/src/bn_c384_256.cpp.o"
+  "CMakeFiles/mclbn384_256.dir/src/bn_c384_256.cpp.o.d"
+  "lib/libmclbn384_256.a"
+  "lib/libmclbn384_256.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/mclbn384_256.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
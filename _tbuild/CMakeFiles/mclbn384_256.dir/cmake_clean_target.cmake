@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "lib/libmclbn384_256.a"
+)
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/bint_test"
+  "../bin/bint_test.pdb"
+  "CMakeFiles/bint_test.dir/bint_test.cpp.o"
+  "CMakeFiles/bint_test.dir/bint_test.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bint_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
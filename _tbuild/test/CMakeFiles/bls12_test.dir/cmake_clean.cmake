@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/bls12_test"
+  "../bin/bls12_test.pdb"
+  "CMakeFiles/bls12_test.dir/bls12_test.cpp.o"
+  "CMakeFiles/bls12_test.dir/bls12_test.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bls12_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/bn_c384_256_test"
+  "../bin/bn_c384_256_test.pdb"
+  "CMakeFiles/bn_c384_256_test.dir/bn_c384_256_test.cpp.o"
+  "CMakeFiles/bn_c384_256_test.dir/bn_c384_256_test.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bn_c384_256_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/ec_test"
+  "../bin/ec_test.pdb"
+  "CMakeFiles/ec_test.dir/ec_test.cpp.o"
+  "CMakeFiles/ec_test.dir/ec_test.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ec_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/elgamal_test"
+  "../bin/elgamal_test.pdb"
+  "CMakeFiles/elgamal_test.dir/elgamal_test.cpp.o"
+  "CMakeFiles/elgamal_test.dir/elgamal_test.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/elgamal_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
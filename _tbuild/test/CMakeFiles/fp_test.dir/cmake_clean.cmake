@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/fp_test"
+  "../bin/fp_test.pdb"
+  "CMakeFiles/fp_test.dir/fp_test.cpp.o"
+  "CMakeFiles/fp_test.dir/fp_test.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/fp_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/fp_tower_test"
+  "../bin/fp_tower_test.pdb"
+  "CMakeFiles/fp_tower_test.dir/fp_tower_test.cpp.o"
+  "CMakeFiles/fp_tower_test.dir/fp_tower_test.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/fp_tower_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
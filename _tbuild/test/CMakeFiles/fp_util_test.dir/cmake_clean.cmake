@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/fp_util_test"
+  "../bin/fp_util_test.pdb"
+  "CMakeFiles/fp_util_test.dir/fp_util_test.cpp.o"
+  "CMakeFiles/fp_util_test.dir/fp_util_test.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/fp_util_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
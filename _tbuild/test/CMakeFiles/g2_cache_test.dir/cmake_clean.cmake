@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/g2_cache_test"
+  "../bin/g2_cache_test.pdb"
+  "CMakeFiles/g2_cache_test.dir/g2_cache_test.cpp.o"
+  "CMakeFiles/g2_cache_test.dir/g2_cache_test.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/g2_cache_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/glv_test"
+  "../bin/glv_test.pdb"
+  "CMakeFiles/glv_test.dir/glv_test.cpp.o"
+  "CMakeFiles/glv_test.dir/glv_test.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/glv_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
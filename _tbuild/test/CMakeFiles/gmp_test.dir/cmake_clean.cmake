@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/gmp_test"
+  "../bin/gmp_test.pdb"
+  "CMakeFiles/gmp_test.dir/gmp_test.cpp.o"
+  "CMakeFiles/gmp_test.dir/gmp_test.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gmp_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
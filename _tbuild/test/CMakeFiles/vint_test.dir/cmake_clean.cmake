@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/vint_test"
+  "../bin/vint_test.pdb"
+  "CMakeFiles/vint_test.dir/vint_test.cpp.o"
+  "CMakeFiles/vint_test.dir/vint_test.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/vint_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
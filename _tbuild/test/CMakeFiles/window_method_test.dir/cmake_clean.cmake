@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/window_method_test"
+  "../bin/window_method_test.pdb"
+  "CMakeFiles/window_method_test.dir/window_method_test.cpp.o"
+  "CMakeFiles/window_method_test.dir/window_method_test.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/window_method_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
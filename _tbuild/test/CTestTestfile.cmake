@@ -0,0 +1,40 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/test
+# Build directory: /root/repo/_tbuild/test
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(fp_test "/root/repo/_tbuild/bin/fp_test")
+set_tests_properties(fp_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;16;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(ec_test "/root/repo/_tbuild/bin/ec_test")
+set_tests_properties(ec_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;16;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(fp_util_test "/root/repo/_tbuild/bin/fp_util_test")
+set_tests_properties(fp_util_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;16;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(window_method_test "/root/repo/_tbuild/bin/window_method_test")
+set_tests_properties(window_method_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;16;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(elgamal_test "/root/repo/_tbuild/bin/elgamal_test")
+set_tests_properties(elgamal_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;16;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(bls12_test "/root/repo/_tbuild/bin/bls12_test")
+set_tests_properties(bls12_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;16;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(fp_tower_test "/root/repo/_tbuild/bin/fp_tower_test")
+set_tests_properties(fp_tower_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;16;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(gmp_test "/root/repo/_tbuild/bin/gmp_test")
+set_tests_properties(gmp_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;16;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(bn_test "/root/repo/_tbuild/bin/bn_test")
+set_tests_properties(bn_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;16;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(glv_test "/root/repo/_tbuild/bin/glv_test")
+set_tests_properties(glv_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;16;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(g2_cache_test "/root/repo/_tbuild/bin/g2_cache_test")
+set_tests_properties(g2_cache_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;16;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(thread_pool_test "/root/repo/_tbuild/bin/thread_pool_test")
+set_tests_properties(thread_pool_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;16;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(bn_c256_test "/root/repo/_tbuild/bin/bn_c256_test")
+set_tests_properties(bn_c256_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;29;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(bn_c384_test "/root/repo/_tbuild/bin/bn_c384_test")
+set_tests_properties(bn_c384_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;29;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(bn_c384_256_test "/root/repo/_tbuild/bin/bn_c384_256_test")
+set_tests_properties(bn_c384_256_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;29;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(bint_test "/root/repo/_tbuild/bin/bint_test")
+set_tests_properties(bint_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;48;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(vint_test "/root/repo/_tbuild/bin/vint_test")
+set_tests_properties(vint_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;48;add_test;/root/repo/test/CMakeLists.txt;0;")
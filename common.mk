@@ -130,6 +130,10 @@ ifeq ($(MCL_STATIC_CODE),1)
   MCL_MAX_BIT_SIZE=384
   CFLAGS+=-DMCL_STATIC_CODE
 endif
+ifeq ($(MCL_USE_STD_THREAD),1)
+  CFLAGS+=-DMCL_USE_STD_THREAD
+  LDFLAGS+=-lpthread
+endif
 ifeq ($(MCL_USE_OMP),1)
   CFLAGS+=-DMCL_USE_OMP
   ifeq ($(OS),mac)
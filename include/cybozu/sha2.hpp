@@ -246,6 +246,20 @@ inline uint64_t rot64(uint64_t x, int s)
 #endif
 }
 
+/*
+	update h by blockNum blocks of buf (64 * blockNum bytes)
+	a library may set a faster one (e.g. SHA extensions of x86) by Sha256::setBlockFunc
+*/
+typedef void (*Sha256BlockFunc)(uint32_t h[8], const uint8_t *buf, size_t blockNum);
+
+template<int dummy = 0>
+struct Sha256BlockFuncHolder {
+	static Sha256BlockFunc f;
+};
+
+template<int dummy>
+Sha256BlockFunc Sha256BlockFuncHolder<dummy>::f = 0;
+
 template<class T>
 struct Common {
 	void term(uint8_t *buf, size_t bufSize)
@@ -278,11 +292,12 @@ struct Common {
 			self.round(self.roundBuf_);
 			self.roundBufSize_ = 0;
 		}
-		while (bufSize >= T::blockSize_) {
+		if (bufSize >= T::blockSize_) {
 			assert(self.roundBufSize_ == 0);
-			self.round(buf);
-			buf += T::blockSize_;
-			bufSize -= T::blockSize_;
+			const size_t n = bufSize / T::blockSize_;
+			self.roundN(buf, n);
+			buf += T::blockSize_ * n;
+			bufSize -= T::blockSize_ * n;
 		}
 		if (bufSize > 0) {
 			assert(bufSize < T::blockSize_);
@@ -333,6 +348,25 @@ private:
 		@param buf [in] buffer(64byte)
 	*/
 	void round(const uint8_t *buf)
+	{
+		roundN(buf, 1);
+	}
+	/**
+		@param buf [in] buffer(64 * n byte)
+	*/
+	void roundN(const uint8_t *buf, size_t n)
+	{
+		sha2_local::Sha256BlockFunc f = getBlockFunc();
+		if (f) {
+			f(h_, buf, n);
+			totalSize_ += blockSize_ * n;
+			return;
+		}
+		for (size_t i = 0; i < n; i++) {
+			roundPortable(buf + blockSize_ * i);
+		}
+	}
+	void roundPortable(const uint8_t *buf)
 	{
 		using namespace sha2_local;
 		uint32_t w[64];
@@ -370,6 +404,18 @@ public:
 	{
 		clear();
 	}
+	/*
+		set f as the compression function of all Sha256 instead of the portable one
+		f = 0 restores the portable one
+	*/
+	static void setBlockFunc(sha2_local::Sha256BlockFunc f)
+	{
+		sha2_local::Sha256BlockFuncHolder<>::f = f;
+	}
+	static sha2_local::Sha256BlockFunc getBlockFunc()
+	{
+		return sha2_local::Sha256BlockFuncHolder<>::f;
+	}
 	void clear()
 	{
 		static const uint32_t kTbl[] = {
@@ -498,6 +544,12 @@ private:
 		}
 		totalSize_ += blockSize_;
 	}
+	void roundN(const uint8_t *buf, size_t n)
+	{
+		for (size_t i = 0; i < n; i++) {
+			round(buf + blockSize_ * i);
+		}
+	}
 public:
 	Sha512()
 	{
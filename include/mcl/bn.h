@@ -229,6 +229,25 @@ MCLBN_DLL_API mclSize mclBnGT_serialize(void *buf, mclSize maxBufSize, const mcl
 MCLBN_DLL_API mclSize mclBnFp_serialize(void *buf, mclSize maxBufSize, const mclBnFp *x);
 MCLBN_DLL_API mclSize mclBnFp2_serialize(void *buf, mclSize maxBufSize, const mclBnFp2 *x);
 
+/*
+	compressed serialization of GT (the half size of mclBnGT_serialize)
+	x must be in the cyclotomic subgroup (e.g. the output of mclBn_finalExp)
+	return written byte if sucess else 0
+*/
+MCLBN_DLL_API mclSize mclBnGT_serializeCompressed(void *buf, mclSize maxBufSize, const mclBnGT *x);
+/*
+	deserialize x serialized by mclBnGT_serializeCompressed
+	the order of x is verified if mclBn_verifyOrderGT(1) as mclBnGT_deserialize
+	return read size if success else 0
+*/
+MCLBN_DLL_API mclSize mclBnGT_deserializeCompressed(mclBnGT *x, const void *buf, mclSize bufSize);
+/*
+	deserialize x[0], ..., x[n-1] from the concatenation of the outputs of mclBnGT_serializeCompressed
+	faster than calling mclBnGT_deserializeCompressed n times
+	return read size if success else 0
+*/
+MCLBN_DLL_API mclSize mclBnGT_deserializeCompressedVec(mclBnGT *x, const void *buf, mclSize bufSize, mclSize n);
+
 /*
 	set string
 	ioMode
@@ -385,6 +404,14 @@ MCLBN_DLL_API int mclBnG1_isValidOrder(const mclBnG1 *x);
 MCLBN_DLL_API int mclBnG1_hashAndMapTo(mclBnG1 *x, const void *buf, mclSize bufSize);
 // user-defined dst
 MCLBN_DLL_API int mclBnG1_hashAndMapToWithDst(mclBnG1 *x, const void *buf, mclSize bufSize, const char *dst, mclSize dstSize);
+/*
+	x[i] = hashAndMapTo(bufVec[i], bufSizeVec[i]) for i = 0, ..., n-1
+	x[i] are normalized and the inversions are shared among the messages
+	return 0 if success else -1 (a temporary buffer is allocated if sizeof(mclSize) != sizeof(size_t))
+*/
+MCLBN_DLL_API int mclBnG1_hashAndMapToVec(mclBnG1 *x, const void *const *bufVec, const mclSize *bufSizeVec, mclSize n);
+// multi thread version of mclBnG1_hashAndMapToVec (cpuN = 0 means all cores)
+MCLBN_DLL_API int mclBnG1_hashAndMapToVecMT(mclBnG1 *x, const void *const *bufVec, const mclSize *bufSizeVec, mclSize n, mclSize cpuN);
 // set default dst
 MCLBN_DLL_API int mclBnG1_setDst(const char *dst, mclSize dstSize);
 
@@ -415,6 +442,14 @@ MCLBN_DLL_API int mclBnG2_isValidOrder(const mclBnG2 *x);
 MCLBN_DLL_API int mclBnG2_hashAndMapTo(mclBnG2 *x, const void *buf, mclSize bufSize);
 // user-defined dst
 MCLBN_DLL_API int mclBnG2_hashAndMapToWithDst(mclBnG2 *x, const void *buf, mclSize bufSize, const char *dst, mclSize dstSize);
+/*
+	x[i] = hashAndMapTo(bufVec[i], bufSizeVec[i]) for i = 0, ..., n-1
+	x[i] are normalized and the inversions are shared among the messages
+	return 0 if success else -1 (a temporary buffer is allocated if sizeof(mclSize) != sizeof(size_t))
+*/
+MCLBN_DLL_API int mclBnG2_hashAndMapToVec(mclBnG2 *x, const void *const *bufVec, const mclSize *bufSizeVec, mclSize n);
+// multi thread version of mclBnG2_hashAndMapToVec (cpuN = 0 means all cores)
+MCLBN_DLL_API int mclBnG2_hashAndMapToVecMT(mclBnG2 *x, const void *const *bufVec, const mclSize *bufSizeVec, mclSize n, mclSize cpuN);
 // set default dst
 MCLBN_DLL_API int mclBnG2_setDst(const char *dst, mclSize dstSize);
 
@@ -442,6 +477,8 @@ MCLBN_DLL_API void mclBnGT_setInt32(mclBnGT *y, int x);
 MCLBN_DLL_API int mclBnGT_isEqual(const mclBnGT *x, const mclBnGT *y);
 MCLBN_DLL_API int mclBnGT_isZero(const mclBnGT *x);
 MCLBN_DLL_API int mclBnGT_isOne(const mclBnGT *x);
+// return 1 if x has the order r (x is in GT)
+MCLBN_DLL_API int mclBnGT_isValidOrder(const mclBnGT *x);
 
 MCLBN_DLL_API void mclBnGT_neg(mclBnGT *y, const mclBnGT *x);
 MCLBN_DLL_API void mclBnGT_sqr(mclBnGT *y, const mclBnGT *x);
@@ -470,18 +507,52 @@ MCLBN_DLL_API void mclBnGT_pow(mclBnGT *z, const mclBnGT *x, const mclBnFr *y);
 MCLBN_DLL_API void mclBnG1_mulVec(mclBnG1 *z, mclBnG1 *x, const mclBnFr *y, mclSize n);
 MCLBN_DLL_API void mclBnG2_mulVec(mclBnG2 *z, mclBnG2 *x, const mclBnFr *y, mclSize n);
 MCLBN_DLL_API void mclBnGT_powVec(mclBnGT *z, const mclBnGT *x, const mclBnFr *y, mclSize n);
+/*
+	streaming version of mulVec for x[] and y[] which do not fit in memory
+	read(x, y, maxN, self) sets at most maxN pairs to x[] and y[] and returns the num of them (0 means the end)
+	n is the estimated total num of pairs to choose the window size
+	return 0 if success else -1
+*/
+MCLBN_DLL_API int mclBnG1_mulVecStream(mclBnG1 *z, mclSize (*read)(mclBnG1 *x, mclBnFr *y, mclSize maxN, void *self), void *self, mclSize n);
+MCLBN_DLL_API int mclBnG2_mulVecStream(mclBnG2 *z, mclSize (*read)(mclBnG2 *x, mclBnFr *y, mclSize maxN, void *self), void *self, mclSize n);
 
 MCLBN_DLL_API void mclBn_pairing(mclBnGT *z, const mclBnG1 *x, const mclBnG2 *y);
 MCLBN_DLL_API void mclBn_finalExp(mclBnGT *y, const mclBnGT *x);
+// y[i] = finalExp(x[i]) for i = 0, ..., n-1 (y may be equal to x)
+MCLBN_DLL_API void mclBn_finalExpVec(mclBnGT *y, const mclBnGT *x, mclSize n);
+// multi thread version of mclBn_finalExpVec (cpuN = 0 means all cores)
+MCLBN_DLL_API void mclBn_finalExpVecMT(mclBnGT *y, const mclBnGT *x, mclSize n, mclSize cpuN);
 MCLBN_DLL_API void mclBn_millerLoop(mclBnGT *z, const mclBnG1 *x, const mclBnG2 *y);
 // z = prod_{i=0}^{n-1} millerLoop(x[i], y[i])
 MCLBN_DLL_API void mclBn_millerLoopVec(mclBnGT *z, const mclBnG1 *x, const mclBnG2 *y, mclSize n);
-// multi thread version of millerLoopVec/mclBnG1_mulVec/mclBnG2_mulVec (enabled if the library built with MCL_USE_OMP=1)
+// multi thread version of millerLoopVec/mclBnG1_mulVec/mclBnG2_mulVec (enabled if the library built with MCL_USE_OMP=1 or MCL_USE_STD_THREAD=1)
 // the num of thread is automatically detected if cpuN = 0
 // x[] may be normalized (the values are not changed) when computing z
 MCLBN_DLL_API void mclBn_millerLoopVecMT(mclBnGT *z, const mclBnG1 *x, const mclBnG2 *y, mclSize n, mclSize cpuN);
 MCLBN_DLL_API void mclBnG1_mulVecMT(mclBnG1 *z, mclBnG1 *x, const mclBnFr *y, mclSize n, mclSize cpuN);
 MCLBN_DLL_API void mclBnG2_mulVecMT(mclBnG2 *z, mclBnG2 *x, const mclBnFr *y, mclSize n, mclSize cpuN);
+// set the num of threads of the pool used by the above functions (the num of hardware threads if n = 0)
+// return 0 if success else -1 (the library is not built with MCL_USE_STD_THREAD=1)
+// do not call this while the above functions are running
+MCLBN_DLL_API int mclBn_setThreadPoolSize(mclSize n);
+
+/*
+	LRU cache of validated G2 points and their precomputed line coefficients keyed by the serialized bytes
+	mclBnG2_deserialize uses it for compressed G2 if the cache is enabled
+	the order of a cached point is always verified
+	maxByte : the max total size of the cache (0 disables and clears it)
+	return 0 if success else -1 (the library is built with MCL_NO_G2_CACHE or without C++11)
+*/
+MCLBN_DLL_API int mclBn_setG2CacheMaxByte(mclSize maxByte);
+MCLBN_DLL_API void mclBn_getG2CacheStat(uint64_t *hitNum, uint64_t *missNum, mclSize *byteSize);
+// clear all entries and the counters
+MCLBN_DLL_API void mclBn_clearG2Cache(void);
+/*
+	f = MillerLoop(P, Q) where Q is deserialized buf[bufSize]
+	use the cached line coefficients of Q if the cache is enabled
+	return 0 if success else -1 (buf is not a valid G2 point)
+*/
+MCLBN_DLL_API int mclBn_millerLoopCachedG2(mclBnGT *f, const mclBnG1 *P, const void *buf, mclSize bufSize);
 
 // return precomputedQcoeffSize * sizeof(Fp6) / sizeof(uint64_t)
 MCLBN_DLL_API int mclBn_getUint64NumToPrecompute(void);
@@ -492,6 +563,32 @@ MCLBN_DLL_API void mclBn_precomputeG2(uint64_t *Qbuf, const mclBnG2 *Q);
 MCLBN_DLL_API void mclBn_precomputedMillerLoop(mclBnGT *f, const mclBnG1 *P, const uint64_t *Qbuf);
 MCLBN_DLL_API void mclBn_precomputedMillerLoop2(mclBnGT *f, const mclBnG1 *P1, const uint64_t *Q1buf, const mclBnG1 *P2, const uint64_t *Q2buf);
 MCLBN_DLL_API void mclBn_precomputedMillerLoop2mixed(mclBnGT *f, const mclBnG1 *P1, const mclBnG2 *Q1, const mclBnG1 *P2, const uint64_t *Q2buf);
+// QbufVec = [Qbuf_0, ..., Qbuf_{n-1}] where Qbuf_i = QbufVec + i * mclBn_getUint64NumToPrecompute() is set by mclBn_precomputeG2
+// f = prod_{i=0}^{n-1} MillerLoop(Pvec[i], Qbuf_i)
+MCLBN_DLL_API void mclBn_precomputedMillerLoopVec(mclBnGT *f, const mclBnG1 *Pvec, const uint64_t *QbufVec, mclSize n);
+// f = prod_{i=0}^{n1-1} MillerLoop(P1vec[i], Q1vec[i]) * prod_{j=0}^{n2-1} MillerLoop(P2vec[j], Q2buf_j)
+MCLBN_DLL_API void mclBn_precomputedMillerLoopVecMixed(mclBnGT *f, const mclBnG1 *P1vec, const mclBnG2 *Q1vec, mclSize n1, const mclBnG1 *P2vec, const uint64_t *Q2bufVec, mclSize n2);
+
+// return precomputedQcoeffSize * 2 * sizeof(Fp2) / sizeof(uint64_t) (2/3 of mclBn_getUint64NumToPrecompute())
+MCLBN_DLL_API int mclBn_getUint64NumToPrecomputeAffine(void);
+// allocate Qbuf[mclBn_getUint64NumToPrecomputeAffine()] before calling this
+MCLBN_DLL_API void mclBn_precomputeG2Affine(uint64_t *Qbuf, const mclBnG2 *Q);
+/*
+	f = MillerLoop(P, Qbuf) where Qbuf is set by mclBn_precomputeG2Affine
+	the result is equal to the one of mclBn_precomputedMillerLoop after mclBn_finalExp (not before mclBn_finalExp)
+*/
+MCLBN_DLL_API void mclBn_precomputedMillerLoopAffine(mclBnGT *f, const mclBnG1 *P, const uint64_t *Qbuf);
+// QbufVec = [Qbuf_0, ..., Qbuf_{n-1}] where Qbuf_i = QbufVec + i * mclBn_getUint64NumToPrecomputeAffine() is set by mclBn_precomputeG2Affine
+MCLBN_DLL_API void mclBn_precomputedMillerLoopAffineVec(mclBnGT *f, const mclBnG1 *Pvec, const uint64_t *QbufVec, mclSize n);
+
+/*
+	verify prod_{j=0}^{nVec[i]-1} e(P_ij, Q_ij) == 1 for all i = 0, ..., k-1 by one multi-pairing
+	Pvec and Qvec are the concatenations of the pairs of the equations
+	the equations are merged with random 128-bit scalars
+	if okVec is not NULL, okVec[i] = 1 if the i-th equation holds else 0
+	return 1 if all equations hold, 0 if not, -1 if not supported
+*/
+MCLBN_DLL_API int mclBn_verifyPairingEquations(int *okVec, const mclBnG1 *Pvec, const mclBnG2 *Qvec, const mclSize *nVec, mclSize k);
 
 /*
 	Lagrange interpolation
@@ -521,6 +618,12 @@ MCLBN_DLL_API int mclBn_G2EvaluatePolynomial(mclBnG2 *out, const mclBnG2 *cVec,
 */
 MCLBN_DLL_API void mclBn_verifyOrderG1(int doVerify);
 MCLBN_DLL_API void mclBn_verifyOrderG2(int doVerify);
+/*
+	verify whether an element of GT has order r
+	This api affetcs setStr(), deserialize() for GT
+	@param doVerify [in] does not verify if zero(default 0)
+*/
+MCLBN_DLL_API void mclBn_verifyOrderGT(int doVerify);
 
 /*
 	EXPERIMENTAL
@@ -18,13 +18,18 @@ template<class T>
 void mulByCofactorBLS12fast(T& Q, const T& P);
 
 } } // mcl::local
+#include <cybozu/sha2.hpp>
 #include <mcl/mapto_wb19.hpp>
 #include <assert.h>
+#include <new>
 #ifndef CYBOZU_DONT_USE_EXCEPTION
 #include <vector>
+#include <algorithm>
 #endif
 
-#ifdef MCL_USE_OMP
+#ifdef MCL_USE_STD_THREAD
+#include <mcl/thread_pool.hpp>
+#elif defined(MCL_USE_OMP)
 #include <omp.h>
 #endif
 
@@ -282,6 +287,62 @@ public:
 		z *= x_org;
 		z *= d62;
 	}
+	/*
+		z = x^e over compression for a sparse e >= 0
+		naf is the signed binary representation of e (the most significant digit first)
+		x must be in the cyclotomic subgroup
+		the squared values for the nonzero digits are decompressed with one inversion
+		return false (z is not changed) if there are too many nonzero digits
+		or the decompression is not available
+	*/
+	static bool powSparse(Fp12& z, const Fp12& x, const SignVec& naf)
+	{
+		const size_t maxN = 16;
+		const size_t n = naf.size();
+		if (n == 0) {
+			z = 1;
+			return true;
+		}
+		if (x.isOne()) {
+			z = 1;
+			return true;
+		}
+		Fp12 d[maxN];
+		Fp2 nume[maxN], denomi[maxN];
+		int sign[maxN];
+		size_t m = 0;
+		Fp12 t;
+		Compress c(t, x);
+		for (size_t i = 1; i < n; i++) {
+			squareC(c);
+			const int v = naf[n - 1 - i];
+			if (v == 0) continue;
+			if (m == maxN) return false;
+			Compress cm(d[m], c);
+			cm.decompressBeforeInv(nume[m], denomi[m]);
+			if (denomi[m].isZero()) return false;
+			sign[m] = v;
+			m++;
+		}
+		mcl::invVec(denomi, denomi, m, maxN);
+		Fp12 y;
+		if (naf[n - 1] == 0) {
+			y = 1;
+		} else if (naf[n - 1] > 0) {
+			y = x;
+		} else {
+			Fp12::unitaryInv(y, x);
+		}
+		for (size_t i = 0; i < m; i++) {
+			Compress cm(d[i], d[i]);
+			Fp2::mul(cm.g1_, nume[i], denomi[i]);
+			cm.decompressAfterInv();
+			if (sign[i] < 0) Fp12::unitaryInv(d[i], d[i]);
+			y *= d[i];
+		}
+		z = y;
+		return true;
+	}
 };
 
 struct MapTo {
@@ -644,7 +705,10 @@ struct GLV1 : mcl::GLV1T<G1, Fr> {
 	}
 	static void initForBN(const mpz_class& z, bool isBLS12 = false, int curveType = -1)
 	{
-		if (usePrecomputedTable(curveType)) return;
+		if (usePrecomputedTable(curveType)) {
+			initSplitter();
+			return;
+		}
 		bool b = Fp::squareRoot(rw, -3);
 		assert(b);
 		(void)b;
@@ -678,6 +742,7 @@ struct GLV1 : mcl::GLV1T<G1, Fr> {
 		const mpz_class& r = Fr::getOp().mp;
 		v0 = ((-B[1][1]) << rBitSize) / r;
 		v1 = ((B[1][0]) << rBitSize) / r;
+		initSplitter();
 	}
 };
 
@@ -695,6 +760,8 @@ struct GLV2T {
 	static mpz_class z;
 	static mpz_class abs_z;
 	static bool isBLS12;
+	static mcl::ec::local::UnitSplitter<4, Fr::maxSize> splitter;
+	static Unit abs_zUnit; // abs_z if it is less than 2^UnitBitSize else 0
 	static void init(const mpz_class& z, bool isBLS12 = false)
 	{
 		const mpz_class& r = Fr::getOp().mp;
@@ -747,6 +814,9 @@ struct GLV2T {
 			v[2] = ((z * (1 + z * (4 + z * 6))) << rBitSize) / r;
 			v[3] = -((z * (1 + z * 2)) << rBitSize) / r;
 		}
+		splitter.init(Fr::getUnitSize(), rBitSize, v, B);
+		abs_zUnit = 0;
+		if (mcl::gmp::getUnitSize(abs_z) == 1) abs_zUnit = mcl::gmp::getUnit(abs_z)[0];
 	}
 	/*
 		u[] = [x, 0, 0, 0] - v[] * x * B
@@ -786,6 +856,35 @@ struct GLV2T {
 			}
 		}
 	}
+	/*
+		same as split but without mpz_class
+		x[Fr::getUnitSize()] < r
+		u + stride * i = |u[i]|, neg[i] = u[i] < 0
+	*/
+	static void split(Unit *u, size_t stride, bool neg[4], const Unit *x)
+	{
+		const size_t n = Fr::getUnitSize();
+		if (isBLS12) {
+			if (abs_zUnit == 0) {
+				mcl::ec::local::splitByMpz<GLV2>(u, stride, neg, x);
+				return;
+			}
+			Unit t[Fr::maxSize];
+			bint::copyN(t, x, n);
+			for (int i = 0; i < 4; i++) {
+				Unit *ui = u + stride * i;
+				bint::clearN(ui, n);
+				ui[0] = bint::divUnit(t, t, n, abs_zUnit);
+				neg[i] = (z < 0) && (i & 1) && ui[0] != 0;
+			}
+			return;
+		}
+		if (splitter.isValid()) {
+			splitter.split(u, stride, neg, x);
+			return;
+		}
+		mcl::ec::local::splitByMpz<GLV2>(u, stride, neg, x);
+	}
 	template<class T>
 	static void mulLambda(T& Q, const T& P)
 	{
@@ -799,6 +898,8 @@ template<class Fr> mpz_class GLV2T<Fr>::v[4];
 template<class Fr> mpz_class GLV2T<Fr>::z;
 template<class Fr> mpz_class GLV2T<Fr>::abs_z;
 template<class Fr> bool GLV2T<Fr>::isBLS12 = false;
+template<class Fr> mcl::ec::local::UnitSplitter<4, Fr::maxSize> GLV2T<Fr>::splitter;
+template<class Fr> Unit GLV2T<Fr>::abs_zUnit = 0;
 
 struct Param {
 	CurveParam cp;
@@ -1066,7 +1167,7 @@ inline void pow_z(Fp12& y, const Fp12& x)
 #if 1
 	if (BN::param.cp.curveType == MCL_BN254) {
 		Compress::fixed_power(y, x);
-	} else {
+	} else if (!Compress::powSparse(y, x, BN::param.zReplTbl)) {
 		Fp12 orgX = x;
 		y = x;
 		Fp12 conj;
@@ -1311,6 +1412,58 @@ inline void mul_041(Fp12& z, const Fp6& x)
 	Fp2::add(z.a.b, z0x0.b, z1x1.a);
 	Fp2::add(z.a.c, z0x0.c, z1x1.b);
 }
+/*
+	same as mul_403 for x.b = 1
+*/
+inline void mul_403_b1(Fp12& z, const Fp6& x)
+{
+	const Fp2& a = x.a;
+	const Fp2& c = x.c;
+	Fp6& z0 = z.a;
+	Fp6& z1 = z.b;
+	Fp6 z0x0, z1x1, t0;
+	Fp2 t1;
+	t1 = c;
+	t1.a += Fp::one();
+	Fp6::add(t0, z0, z1);
+	z0x0 = z0;
+	Fp6mul_01(z1x1, z1, c, a);
+	Fp6mul_01(t0, t0, t1, a);
+	Fp6::sub(z.b, t0, z0x0);
+	z.b -= z1x1;
+	// a + bv + cv^2 = cxi + av + bv^2
+	Fp2::mul_xi(z1x1.c, z1x1.c);
+	Fp2::add(z.a.a, z0x0.a, z1x1.c);
+	Fp2::add(z.a.b, z0x0.b, z1x1.a);
+	Fp2::add(z.a.c, z0x0.c, z1x1.b);
+}
+/*
+	same as mul_041 for x.b = 1
+*/
+inline void mul_041_b1(Fp12& z, const Fp6& x)
+{
+	const Fp2& a = x.a;
+	const Fp2& c = x.c;
+	Fp6& z0 = z.a;
+	Fp6& z1 = z.b;
+	Fp6 z0x0, z1x1, t0;
+	Fp2 t1;
+	Fp2::mul_xi(z1x1.a, z1.c);
+	z1x1.b = z1.a;
+	z1x1.c = z1.b;
+	t1 = c;
+	t1.a += Fp::one();
+	Fp6::add(t0, z0, z1);
+	Fp6mul_01(z0x0, z0, a, c);
+	Fp6mul_01(t0, t0, a, t1);
+	Fp6::sub(z.b, t0, z0x0);
+	z.b -= z1x1;
+	// a + bv + cv^2 = cxi + av + bv^2
+	Fp2::mul_xi(z1x1.c, z1x1.c);
+	Fp2::add(z.a.a, z0x0.a, z1x1.c);
+	Fp2::add(z.a.b, z0x0.b, z1x1.a);
+	Fp2::add(z.a.c, z0x0.c, z1x1.b);
+}
 inline void mulSparse(Fp12& z, const Fp6& x)
 {
 	if (BN::param.cp.isMtype) {
@@ -1339,6 +1492,15 @@ inline void convertFp6toFp12(Fp12& y, const Fp6& x)
 		y.b.c.clear();
 	}
 }
+// mulSparse for x.b = 1
+inline void mulSparse_b1(Fp12& z, const Fp6& x)
+{
+	if (BN::param.cp.isMtype) {
+		mul_041_b1(z, x);
+	} else {
+		mul_403_b1(z, x);
+	}
+}
 inline void mulSparse2(Fp12& z, const Fp6& x, const Fp6& y)
 {
 	convertFp6toFp12(z, x);
@@ -1371,8 +1533,10 @@ inline void expHardPartBLS12(Fp12& y, const Fp12& x)
 	/*
 		Efficient Final Exponentiation via Cyclotomic Structure
 		for Pairings over Families of Elliptic Curves
+		D. Hayashida, K. Hayasaka, T. Teruya
 		https://eprint.iacr.org/2020/875.pdf p.13
 		(z-1)^2 (z+p)(z^2+p^2-1)+3
+		5 pow_z and 1 fasterSqr (the following #else part needs 5 pow_z and 2 fasterSqr)
 	*/
 	Fp12 a0, a1, a2;
 	pow_z(a0, x); // z
@@ -1409,7 +1573,7 @@ inline void expHardPartBLS12(Fp12& y, const Fp12& x)
 	Fp12::unitaryInv(a1, a1); // x^(2-z)
 	a1 *= a6; // x^(z^5-2z^4+2z^2-z+2)
 	a1 *= x; // x^(z^5-2z^4+2z^2-z+3) = x^c0
-	a3 *= a0; // x^(z^4-2z^3-1) = x^c1
+	a3 *= a0; // x^(z^4-2z^3+2z-1) = x^c1
 	Fp12::Frobenius(a3, a3); // x^(c1 p)
 	a1 *= a3; // x^(c0 + c1 p)
 	a4 *= a2; // x^(z^3-2z^2+z) = x^c2
@@ -1532,6 +1696,113 @@ inline void finalExp(Fp12& y, const Fp12& x)
 		expHardPartBN(y, y);
 	}
 }
+
+namespace local {
+
+/*
+	y[i] = finalExp(x[i]) for i < n <= N
+	the inversions of mapToCyclotomic are shared by invVec
+*/
+template<size_t N>
+void finalExpVecN(Fp12 *y, const Fp12 *x, size_t n)
+{
+	Fp12 z[N], invZ[N];
+	for (size_t i = 0; i < n; i++) {
+		Fp12::Frobenius2(z[i], x[i]); // z = x^(p^2)
+		z[i] *= x[i]; // x^(p^2 + 1)
+	}
+	mcl::invVec(invZ, z, n, N);
+	for (size_t i = 0; i < n; i++) {
+		if (z[i].isZero()) {
+			y[i].clear();
+			continue;
+		}
+		Fp6::neg(z[i].b, z[i].b); // z^(p^6) = conjugate of z
+		Fp12::mul(y[i], invZ[i], z[i]);
+		if (BN::param.isBLS12) {
+			expHardPartBLS12(y[i], y[i]);
+		} else {
+			expHardPartBN(y[i], y[i]);
+		}
+	}
+}
+
+/*
+	split [0, n) into ranges and call f(pos, m) for each [pos, pos + m) in parallel
+	each range has at least minN elements if cpuN = 0 (the num of thread is automatically detected)
+	use getThreadPool() if MCL_USE_STD_THREAD is defined
+*/
+template<class F>
+void runParallel(size_t n, size_t minN, size_t cpuN, const F& f)
+{
+#if defined(MCL_USE_STD_THREAD)
+	ThreadPool& pool = getThreadPool();
+	const size_t taskN = pool.getTaskNum(n, minN, cpuN);
+	if (taskN <= 1) {
+		f(0, n);
+		return;
+	}
+	const size_t q = n / taskN;
+	const size_t r = n % taskN;
+	pool.run(taskN, [&](size_t i) {
+		f(q * i + fp::min_(i, r), q + (i < r));
+	});
+#elif defined(MCL_USE_OMP)
+	if (cpuN == 0) {
+		cpuN = omp_get_num_procs();
+		if (n < minN * cpuN) {
+			cpuN = (n + minN - 1) / minN;
+		}
+	}
+	if (cpuN <= 1 || n <= cpuN) {
+		f(0, n);
+		return;
+	}
+	size_t q = n / cpuN;
+	size_t r = n % cpuN;
+	#pragma omp parallel for
+	for (size_t i = 0; i < cpuN; i++) {
+		f(q * i + fp::min_(i, r), q + (i < r));
+	}
+#else
+	(void)minN;
+	(void)cpuN;
+	f(0, n);
+#endif
+}
+
+} // mcl::bn::local
+
+/*
+	y[i] = finalExp(x[i]) for i = 0, ..., n-1
+	y and x may be the same array
+*/
+inline void finalExpVec(Fp12 *y, const Fp12 *x, size_t n)
+{
+	const size_t N = 16;
+	for (size_t i = 0; i < n; i += N) {
+		local::finalExpVecN<N>(y + i, x + i, fp::min_(n - i, N));
+	}
+}
+
+namespace local {
+
+struct FinalExpVecTask {
+	Fp12 *y;
+	const Fp12 *x;
+	void operator()(size_t pos, size_t n) const { finalExpVec(y + pos, x + pos, n); }
+};
+
+} // mcl::bn::local
+
+// multi thread version of finalExpVec
+// the num of thread is automatically detected if cpuN = 0
+// use getThreadPool() if MCL_USE_STD_THREAD is defined
+inline void finalExpVecMT(Fp12 *y, const Fp12 *x, size_t n, size_t cpuN = 0)
+{
+	const local::FinalExpVecTask task = { y, x };
+	local::runParallel(n, 4, cpuN, task);
+}
 inline void millerLoop(Fp12& f, const G1& P_, const G2& Q_)
 {
 	G1 P(P_);
@@ -1707,6 +1978,235 @@ inline void precomputedMillerLoop(Fp12& f, const G1& P, const std::vector<Fp6>&
 	precomputedMillerLoop(f, P, Qcoeff.data());
 }
 #endif
+namespace local {
+
+/*
+	write the lines of precomputeG2 to out in the affine form of precomputeG2Affine
+	(a, b, c) of dblLineWithoutP -> (-a/b, -3c/b) for adjP = (3P.x, -P.y)
+	(a, b, c) of addLineWithoutP -> (a/b, c/b)
+	b is inverted by one inversion per N lines
+*/
+template<size_t N>
+struct AffineLineWriter {
+	Fp2 *out;
+	Fp2 b[N];
+	size_t n;
+	explicit AffineLineWriter(Fp2 *out) : out(out), n(0) {}
+	void put(const Fp6& l, bool isDbl)
+	{
+		Fp2 *p = out + n * 2;
+		if (isDbl) {
+			Fp2::neg(p[0], l.a);
+			Fp2::mul2(p[1], l.c);
+			p[1] += l.c;
+			Fp2::neg(p[1], p[1]);
+		} else {
+			p[0] = l.a;
+			p[1] = l.c;
+		}
+		b[n++] = l.b;
+		if (n == N) flush();
+	}
+	void flush()
+	{
+		mcl::invVec(b, b, n, N);
+		for (size_t i = 0; i < n; i++) {
+			out[i * 2] *= b[i];
+			out[i * 2 + 1] *= b[i];
+		}
+		out += n * 2;
+		n = 0;
+	}
+};
+
+/*
+	f *= (q[0]/P.y, 1, q[1] P.x/P.y)
+	l.b must be 1
+*/
+inline void mulAffineLine(Fp12& f, bool& isOne, Fp6& l, const Fp2 *q, const Fp& invPy, const Fp& pxInvPy)
+{
+	Fp2::mulFp(l.a, q[0], invPy);
+	Fp2::mulFp(l.c, q[1], pxInvPy);
+	if (isOne) {
+		convertFp6toFp12(f, l);
+		isOne = false;
+	} else {
+		mulSparse_b1(f, l);
+	}
+}
+
+/*
+	e = prod_i ML(Pvec[i], QcoeffVec[i]) up to a factor removed by finalExp
+	QcoeffVec[i] = QcoeffVec + i * precomputedQcoeffSize * 2 is precomputed by precomputeG2Affine
+	if initF:
+	  _f = e
+	else:
+	  _f *= e
+*/
+template<size_t N>
+inline void precomputedMillerLoopAffineVecN(Fp12& _f, const G1* Pvec, const Fp2* QcoeffVec, size_t n, bool initF)
+{
+	assert(n <= N);
+	const size_t qN = BN::param.precomputedQcoeffSize * 2;
+	Fp invPy[N], pxInvPy[N];
+	const Fp2 *Qcoeff[N];
+	// remove zero elements
+	size_t m = 0;
+	for (size_t i = 0; i < n; i++) {
+		const Fp2 *q = QcoeffVec + i * qN;
+		// the table for Q = 0 is zero and the one for Q != 0 has q[1] = -3X^2/(2YZ) != 0
+		if (Pvec[i].isZero() || (q[0].isZero() && q[1].isZero())) continue;
+		G1 P;
+		G1::normalize(P, Pvec[i]);
+		invPy[m] = P.y;
+		pxInvPy[m] = P.x;
+		Qcoeff[m] = q;
+		m++;
+	}
+	if (m == 0) {
+		if (initF) _f = 1;
+		return;
+	}
+	mcl::invVec(invPy, invPy, m, N);
+	for (size_t i = 0; i < m; i++) {
+		pxInvPy[i] *= invPy[i];
+	}
+	Fp12 f;
+	bool isOne = true;
+	size_t idx = 0;
+	Fp6 l;
+	l.b = 1;
+	for (size_t j = 1; j < BN::param.siTbl.size(); j++) {
+		if (!isOne) Fp12::sqr(f, f);
+		for (size_t i = 0; i < m; i++) {
+			mulAffineLine(f, isOne, l, Qcoeff[i] + idx, invPy[i], pxInvPy[i]);
+		}
+		idx += 2;
+		if (BN::param.siTbl[j]) {
+			for (size_t i = 0; i < m; i++) {
+				mulAffineLine(f, isOne, l, Qcoeff[i] + idx, invPy[i], pxInvPy[i]);
+			}
+			idx += 2;
+		}
+	}
+	if (BN::param.z < 0) {
+		Fp6::neg(f.b, f.b);
+	}
+	if (!BN::param.isBLS12) {
+		for (size_t i = 0; i < m; i++) {
+			mulAffineLine(f, isOne, l, Qcoeff[i] + idx, invPy[i], pxInvPy[i]);
+			mulAffineLine(f, isOne, l, Qcoeff[i] + idx + 2, invPy[i], pxInvPy[i]);
+		}
+	}
+	if (initF) {
+		_f = f;
+	} else {
+		_f *= f;
+	}
+}
+
+} // mcl::bn::local
+
+/*
+	allocate param.precomputedQcoeffSize * 2 elements of Fp2 for Qcoeff
+	each line of precomputeG2 (one Fp6) is normalized to two Fp2
+	so the table is 2/3 the size of the one of precomputeG2
+*/
+inline void precomputeG2Affine(Fp2 *Qcoeff, const G2& Q_)
+{
+	G2 Q(Q_);
+	Q.normalize();
+	if (Q.isZero()) {
+		for (size_t i = 0; i < BN::param.precomputedQcoeffSize * 2; i++) {
+			Qcoeff[i].clear();
+		}
+		return;
+	}
+	local::AffineLineWriter<16> w(Qcoeff);
+	G2 T = Q;
+	G2 negQ;
+	if (BN::param.useNAF) {
+		G2::neg(negQ, Q);
+	}
+	Fp6 l;
+	for (size_t i = 1; i < BN::param.siTbl.size(); i++) {
+		dblLineWithoutP(l, T);
+		w.put(l, true);
+		if (BN::param.siTbl[i]) {
+			addLineWithoutP(l, T, BN::param.siTbl[i] > 0 ? Q : negQ);
+			w.put(l, false);
+		}
+	}
+	if (!BN::param.isBLS12) {
+		if (BN::param.z < 0) {
+			G2::neg(T, T);
+		}
+		Frobenius(Q, Q);
+		addLineWithoutP(l, T, Q);
+		w.put(l, false);
+		Frobenius(Q, Q);
+		G2::neg(Q, Q);
+		addLineWithoutP(l, T, Q);
+		w.put(l, false);
+	}
+	w.flush();
+}
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+inline void precomputeG2Affine(std::vector<Fp2>& Qcoeff, const G2& Q)
+{
+	Qcoeff.resize(BN::param.precomputedQcoeffSize * 2);
+	precomputeG2Affine(Qcoeff.data(), Q);
+}
+#endif
+template<class Array>
+void precomputeG2Affine(bool *pb, Array& Qcoeff, const G2& Q)
+{
+	*pb = Qcoeff.resize(BN::param.precomputedQcoeffSize * 2);
+	if (!*pb) return;
+	precomputeG2Affine(Qcoeff.data(), Q);
+}
+/*
+	e = prod_{i=0}^{n-1} MillerLoop(Pvec[i], QcoeffVec[i])
+	QcoeffVec[i] = QcoeffVec + i * precomputedQcoeffSize * 2 is precomputed by precomputeG2Affine
+	if initF:
+	  f = e
+	else:
+	  f *= e
+	@note the result is equal to the one of precomputedMillerLoopVec after finalExp (not before finalExp)
+*/
+inline void precomputedMillerLoopAffineVec(Fp12& f, const G1* Pvec, const Fp2* QcoeffVec, size_t n, bool initF = true)
+{
+	const size_t N = 64;
+	const size_t qN = BN::param.precomputedQcoeffSize * 2;
+	do {
+		const size_t m = fp::min_(n, N);
+		local::precomputedMillerLoopAffineVecN<N>(f, Pvec, QcoeffVec, m, initF);
+		initF = false;
+		Pvec += m;
+		QcoeffVec += m * qN;
+		n -= m;
+	} while (n > 0);
+}
+/*
+	f = MillerLoop(P, Q) up to a factor removed by finalExp
+	where Qcoeff is precomputed by precomputeG2Affine(Qcoeff, Q)
+*/
+inline void precomputedMillerLoopAffine(Fp12& f, const G1& P, const Fp2* Qcoeff)
+{
+	precomputedMillerLoopAffineVec(f, &P, Qcoeff, 1);
+}
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+inline void precomputedMillerLoopAffine(Fp12& f, const G1& P, const std::vector<Fp2>& Qcoeff)
+{
+	precomputedMillerLoopAffine(f, P, Qcoeff.data());
+}
+// QcoeffVec is the concatenation of n outputs of precomputeG2Affine
+inline void precomputedMillerLoopAffineVec(Fp12& f, const G1* Pvec, const std::vector<Fp2>& QcoeffVec, size_t n, bool initF = true)
+{
+	assert(QcoeffVec.size() >= n * BN::param.precomputedQcoeffSize * 2);
+	precomputedMillerLoopAffineVec(f, Pvec, QcoeffVec.data(), n, initF);
+}
+#endif
 /*
 	f = MillerLoop(P1, Q1) x MillerLoop(P2, Q2)
 	Q2coeff : precomputed Q2
@@ -1972,13 +2472,32 @@ inline void millerLoopVec(Fp12& f, const G1* Pvec, const G2* Qvec, size_t n, boo
 
 // multi thread version of millerLoopVec
 // the num of thread is automatically detected if cpuN = 0
+// use getThreadPool() if MCL_USE_STD_THREAD is defined
 inline void millerLoopVecMT(Fp12& f, const G1* Pvec, const G2* Qvec, size_t n, size_t cpuN = 0)
 {
 	if (n == 0) {
 		f = 1;
 		return;
 	}
-#ifdef MCL_USE_OMP
+#if defined(MCL_USE_STD_THREAD)
+	ThreadPool& pool = getThreadPool();
+	const size_t taskN = pool.getTaskNum(n, 16, cpuN);
+	if (taskN <= 1) {
+		millerLoopVec(f, Pvec, Qvec, n);
+		return;
+	}
+	Fp12 *fs = (Fp12*)CYBOZU_ALLOCA(sizeof(Fp12) * taskN);
+	const size_t q = n / taskN;
+	const size_t r = n % taskN;
+	pool.run(taskN, [&](size_t i) {
+		size_t adj = q * i + fp::min_(i, r);
+		millerLoopVec(fs[i], Pvec + adj, Qvec + adj, q + (i < r));
+	});
+	f = fs[0];
+	for (size_t i = 1; i < taskN; i++) {
+		f *= fs[i];
+	}
+#elif defined(MCL_USE_OMP)
 	const size_t minN = 16;
 	if (cpuN == 0) {
 		cpuN = omp_get_num_procs();
@@ -2010,26 +2529,538 @@ inline void millerLoopVecMT(Fp12& f, const G1* Pvec, const G2* Qvec, size_t n, s
 #endif
 }
 
-inline bool setMapToMode(int mode)
-{
-	return BN::nonConstParam.mapTo.setMapToMode(mode);
-}
-inline int getMapToMode()
-{
-	return BN::param.mapTo.mapToMode_;
-}
-inline void mapToG1(bool *pb, G1& P, const Fp& x) { *pb = BN::param.mapTo.calc(P, x); }
-inline void mapToG2(bool *pb, G2& P, const Fp2& x) { *pb = BN::param.mapTo.calc(P, x); }
-#ifndef CYBOZU_DONT_USE_EXCEPTION
-inline void mapToG1(G1& P, const Fp& x)
-{
-	bool b;
-	mapToG1(&b, P, x);
-	if (!b) throw cybozu::Exception("mapToG1:bad value") << x;
-}
-inline void mapToG2(G2& P, const Fp2& x)
-{
-	bool b;
+namespace local {
+
+/*
+	affine pairs of millerLoopVecAffineN
+	T[i] and Q[i] are affine points of G2
+	invPy[i] = 1/P[i].y, negPxInvPy[i] = -P[i].x/P[i].y
+*/
+template<size_t N>
+struct AffineMillerLoop {
+	Fp2 Tx[N], Ty[N], Qx[N], Qy[N], lam[N];
+	Fp invPy[N], negPxInvPy[N];
+	size_t n;
+	bool isOne; // f = 1
+	/*
+		line through (x, y) with the slope lambda evaluated at P and divided by P.y
+		l = ((lambda x - y)/P.y, 1, -lambda P.x/P.y)
+		it is equal to the one of dblLine/addLine up to a factor in Fp2
+		and the factor is removed by finalExp
+	*/
+	void mulLine(Fp12& f, size_t i)
+	{
+		Fp6 l;
+		Fp2::mul(l.a, lam[i], Tx[i]);
+		l.a -= Ty[i];
+		Fp2::mulFp(l.a, l.a, invPy[i]);
+		l.b = 1;
+		Fp2::mulFp(l.c, lam[i], negPxInvPy[i]);
+		if (isOne) {
+			convertFp6toFp12(f, l);
+			isOne = false;
+		} else {
+			mulSparse_b1(f, l);
+		}
+	}
+	/*
+		lam[i] = 1/den[i] by one inversion
+		return false if some den[i] is zero
+	*/
+	bool invLam()
+	{
+		for (size_t i = 0; i < n; i++) {
+			if (lam[i].isZero()) return false;
+		}
+		mcl::invVec(lam, lam, n, N);
+		return true;
+	}
+	// T[i] = 2T[i] and f *= the tangent lines
+	bool dbl(Fp12& f)
+	{
+		for (size_t i = 0; i < n; i++) {
+			Fp2::mul2(lam[i], Ty[i]);
+		}
+		if (!invLam()) return false;
+		for (size_t i = 0; i < n; i++) {
+			Fp2 t, x3;
+			Fp2::sqr(t, Tx[i]);
+			Fp2::mul2(x3, t);
+			t += x3;
+			lam[i] *= t; // 3x^2/2y
+			mulLine(f, i);
+			Fp2::sqr(x3, lam[i]);
+			x3 -= Tx[i];
+			x3 -= Tx[i];
+			Fp2::sub(t, Tx[i], x3);
+			Tx[i] = x3;
+			Fp2::mul(t, t, lam[i]);
+			Fp2::sub(Ty[i], t, Ty[i]);
+		}
+		return true;
+	}
+	// T[i] += (Qx[i], neg ? -Qy[i] : Qy[i]) and f *= the lines
+	bool add(Fp12& f, bool neg)
+	{
+		for (size_t i = 0; i < n; i++) {
+			Fp2::sub(lam[i], Tx[i], Qx[i]);
+		}
+		if (!invLam()) return false;
+		for (size_t i = 0; i < n; i++) {
+			Fp2 t, x3;
+			if (neg) {
+				Fp2::add(t, Ty[i], Qy[i]);
+			} else {
+				Fp2::sub(t, Ty[i], Qy[i]);
+			}
+			lam[i] *= t;
+			mulLine(f, i);
+			Fp2::sqr(x3, lam[i]);
+			x3 -= Tx[i];
+			x3 -= Qx[i];
+			Fp2::sub(t, Tx[i], x3);
+			Tx[i] = x3;
+			Fp2::mul(t, t, lam[i]);
+			Fp2::sub(Ty[i], t, Ty[i]);
+		}
+		return true;
+	}
+	// Q[i] = Frobenius(Q[i])
+	void FrobeniusQ()
+	{
+		for (size_t i = 0; i < n; i++) {
+			Fp2::Frobenius(Qx[i], Qx[i]);
+			Fp2::Frobenius(Qy[i], Qy[i]);
+			Qx[i] *= BN::param.g2;
+			Qy[i] *= BN::param.g3;
+		}
+	}
+};
+
+/*
+	e = prod_i ML(Pvec[i], Qvec[i]) up to a factor removed by finalExp
+	if initF:
+	  _f = e
+	else:
+	  _f *= e
+	return false (and _f is not changed) if some step needs an inversion of zero
+*/
+template<size_t N>
+inline bool millerLoopVecAffineN(Fp12& _f, const G1* Pvec, const G2* Qvec, size_t n, bool initF)
+{
+	assert(n <= N);
+	AffineMillerLoop<N> ml;
+	// remove zero elements
+	ml.n = 0;
+	for (size_t i = 0; i < n; i++) {
+		if (Pvec[i].isZero() || Qvec[i].isZero()) continue;
+		G1 P;
+		G2 Q;
+		G1::normalize(P, Pvec[i]);
+		G2::normalize(Q, Qvec[i]);
+		if (P.y.isZero()) return false;
+		const size_t j = ml.n++;
+		ml.invPy[j] = P.y;
+		ml.negPxInvPy[j] = P.x;
+		ml.Tx[j] = ml.Qx[j] = Q.x;
+		ml.Ty[j] = ml.Qy[j] = Q.y;
+	}
+	if (ml.n == 0) {
+		if (initF) _f = 1;
+		return true;
+	}
+	mcl::invVec(ml.invPy, ml.invPy, ml.n, N);
+	for (size_t i = 0; i < ml.n; i++) {
+		ml.negPxInvPy[i] *= ml.invPy[i];
+		Fp::neg(ml.negPxInvPy[i], ml.negPxInvPy[i]);
+	}
+	Fp12 f;
+	ml.isOne = true;
+	for (size_t j = 1; j < BN::param.siTbl.size(); j++) {
+		if (!ml.isOne) Fp12::sqr(f, f);
+		if (!ml.dbl(f)) return false;
+		int v = BN::param.siTbl[j];
+		if (v && !ml.add(f, v < 0)) return false;
+	}
+	if (BN::param.z < 0) {
+		Fp6::neg(f.b, f.b);
+	}
+	if (!BN::param.isBLS12) {
+		if (BN::param.z < 0) {
+			for (size_t i = 0; i < ml.n; i++) {
+				Fp2::neg(ml.Ty[i], ml.Ty[i]);
+			}
+		}
+		ml.FrobeniusQ();
+		if (!ml.add(f, false)) return false;
+		ml.FrobeniusQ();
+		if (!ml.add(f, true)) return false;
+	}
+	if (initF) {
+		_f = f;
+	} else {
+		_f *= f;
+	}
+	return true;
+}
+
+} // mcl::bn::local
+
+/*
+	same as millerLoopVec but T[i] are kept in affine coordinates
+	and each step of the Miller loop shares one inversion among all pairs (Montgomery's trick)
+	@note the result is equal to the one of millerLoopVec after finalExp (not before finalExp)
+*/
+inline void millerLoopVecAffine(Fp12& f, const G1* Pvec, const G2* Qvec, size_t n, bool initF = true)
+{
+	const size_t N = 32;
+	if (n == 0) {
+		if (initF) f = 1;
+		return;
+	}
+	for (size_t i = 0; i < n; i += N) {
+		const size_t remain = fp::min_(n - i, N);
+		const bool first = initF && i == 0;
+		if (!local::millerLoopVecAffineN<N>(f, Pvec + i, Qvec + i, remain, first)) {
+			// T[i] = +-Q[i] may happen for a point not in G2
+			millerLoopVecN<N>(f, Pvec + i, Qvec + i, remain, first);
+		}
+	}
+}
+
+namespace local {
+
+inline void mulSparseOrSet(Fp12& f, bool& isOne, const Fp6& l)
+{
+	if (isOne) {
+		convertFp6toFp12(f, l);
+		isOne = false;
+	} else {
+		mulSparse(f, l);
+	}
+}
+
+/*
+	e = prod_i ML(P1vec[i], Q1vec[i]) x prod_j ML(P2vec[j], Q2coeffVec[j])
+	Q2coeffVec[j] = Q2coeffVec + j * precomputedQcoeffSize is precomputed by precomputeG2
+	if initF:
+	  _f = e
+	else:
+	  _f *= e
+*/
+template<size_t N1, size_t N2>
+inline void precomputedMillerLoopVecN(Fp12& _f, const G1* P1vec, const G2* Q1vec, size_t n1, const G1* P2vec, const Fp6* Q2coeffVec, size_t n2, bool initF)
+{
+	assert(n1 <= N1 && n2 <= N2);
+	const size_t qN = BN::param.precomputedQcoeffSize;
+	G1 P1[N1], adjP1[N1];
+	G2 Q1[N1], T[N1], negQ1[N1];
+	G1 P2[N2], adjP2[N2];
+	const Fp6 *Q2coeff[N2];
+	// remove zero elements
+	{
+		size_t realN = 0;
+		for (size_t i = 0; i < n1; i++) {
+			if (!P1vec[i].isZero() && !Q1vec[i].isZero()) {
+				G1::normalize(P1[realN], P1vec[i]);
+				G2::normalize(Q1[realN], Q1vec[i]);
+				T[realN] = Q1[realN];
+				if (BN::param.useNAF) {
+					G2::neg(negQ1[realN], Q1[realN]);
+				}
+				makeAdjP(adjP1[realN], P1[realN]);
+				realN++;
+			}
+		}
+		n1 = realN;
+		realN = 0;
+		for (size_t i = 0; i < n2; i++) {
+			const Fp6& l = Q2coeffVec[i * qN];
+			// the table of precomputeG2 for Q = 0 is [1, ..., 1] and the one for Q != 0 has l.b = 2YZ != 0
+			if (!P2vec[i].isZero() && !(l.b.isZero() && l.c.isZero())) {
+				G1::normalize(P2[realN], P2vec[i]);
+				makeAdjP(adjP2[realN], P2[realN]);
+				Q2coeff[realN] = Q2coeffVec + i * qN;
+				realN++;
+			}
+		}
+		n2 = realN;
+		if (n1 + n2 == 0) {
+			if (initF) _f = 1;
+			return;
+		}
+	}
+	Fp12 f;
+	bool isOne = true;
+	size_t idx = 0;
+	Fp6 d, e;
+	for (size_t j = 1; j < BN::param.siTbl.size(); j++) {
+		if (!isOne) Fp12::sqr(f, f);
+		for (size_t i = 0; i < n1; i++) {
+			dblLine(e, T[i], adjP1[i]);
+			mulSparseOrSet(f, isOne, e);
+		}
+		for (size_t i = 0; i < n2; i++) {
+			mulFp6cb_by_G1xy(e, Q2coeff[i][idx], adjP2[i]);
+			mulSparseOrSet(f, isOne, e);
+		}
+		idx++;
+		const int v = BN::param.siTbl[j];
+		if (v) {
+			for (size_t i = 0; i < n1; i++) {
+				addLine(e, T[i], v > 0 ? Q1[i] : negQ1[i], P1[i]);
+				mulSparse(f, e);
+			}
+			for (size_t i = 0; i < n2; i++) {
+				mulFp6cb_by_G1xy(e, Q2coeff[i][idx], P2[i]);
+				mulSparse(f, e);
+			}
+			idx++;
+		}
+	}
+	if (BN::param.z < 0) {
+		Fp6::neg(f.b, f.b);
+	}
+	if (!BN::param.isBLS12) {
+		Fp12 ft;
+		for (size_t i = 0; i < n1; i++) {
+			if (BN::param.z < 0) {
+				G2::neg(T[i], T[i]);
+			}
+			Frobenius(Q1[i], Q1[i]);
+			addLine(d, T[i], Q1[i], P1[i]);
+			Frobenius(Q1[i], Q1[i]);
+			G2::neg(Q1[i], Q1[i]);
+			addLine(e, T[i], Q1[i], P1[i]);
+			mulSparse2(ft, d, e);
+			f *= ft;
+		}
+		for (size_t i = 0; i < n2; i++) {
+			mulFp6cb_by_G1xy(d, Q2coeff[i][idx], P2[i]);
+			mulFp6cb_by_G1xy(e, Q2coeff[i][idx + 1], P2[i]);
+			mulSparse2(ft, d, e);
+			f *= ft;
+		}
+	}
+	if (initF) {
+		_f = f;
+	} else {
+		_f *= f;
+	}
+}
+
+} // mcl::bn::local
+
+/*
+	f = prod_{i=0}^{n1-1} MillerLoop(P1vec[i], Q1vec[i]) x prod_{j=0}^{n2-1} MillerLoop(P2vec[j], Q2coeffVec[j])
+	Q2coeffVec[j] = Q2coeffVec + j * precomputedQcoeffSize is precomputed by precomputeG2
+	if initF:
+	  f = _f
+	else:
+	  f *= _f
+	the result is equal to the one of millerLoopVec
+*/
+inline void precomputedMillerLoopVecMixed(Fp12& f, const G1* P1vec, const G2* Q1vec, size_t n1, const G1* P2vec, const Fp6* Q2coeffVec, size_t n2, bool initF = true)
+{
+	const size_t N1 = 16;
+	const size_t N2 = 64;
+	const size_t qN = BN::param.precomputedQcoeffSize;
+	do {
+		const size_t m1 = fp::min_(n1, N1);
+		const size_t m2 = fp::min_(n2, N2);
+		local::precomputedMillerLoopVecN<N1, N2>(f, P1vec, Q1vec, m1, P2vec, Q2coeffVec, m2, initF);
+		initF = false;
+		P1vec += m1;
+		Q1vec += m1;
+		n1 -= m1;
+		P2vec += m2;
+		Q2coeffVec += m2 * qN;
+		n2 -= m2;
+	} while (n1 > 0 || n2 > 0);
+}
+/*
+	f = prod_{i=0}^{n-1} MillerLoop(Pvec[i], QcoeffVec[i])
+	QcoeffVec[i] = QcoeffVec + i * precomputedQcoeffSize is precomputed by precomputeG2
+*/
+inline void precomputedMillerLoopVec(Fp12& f, const G1* Pvec, const Fp6* QcoeffVec, size_t n, bool initF = true)
+{
+	precomputedMillerLoopVecMixed(f, 0, 0, 0, Pvec, QcoeffVec, n, initF);
+}
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+// QcoeffVec is the concatenation of n outputs of precomputeG2
+inline void precomputedMillerLoopVec(Fp12& f, const G1* Pvec, const std::vector<Fp6>& QcoeffVec, size_t n, bool initF = true)
+{
+	assert(QcoeffVec.size() >= n * BN::param.precomputedQcoeffSize);
+	precomputedMillerLoopVec(f, Pvec, QcoeffVec.data(), n, initF);
+}
+inline void precomputedMillerLoopVecMixed(Fp12& f, const G1* P1vec, const G2* Q1vec, size_t n1, const G1* P2vec, const std::vector<Fp6>& Q2coeffVec, size_t n2, bool initF = true)
+{
+	assert(Q2coeffVec.size() >= n2 * BN::param.precomputedQcoeffSize);
+	precomputedMillerLoopVecMixed(f, P1vec, Q1vec, n1, P2vec, Q2coeffVec.data(), n2, initF);
+}
+
+namespace local {
+
+// order of normalized points to gather the same points
+struct G2IndexLess {
+	const G2 *Qvec;
+	explicit G2IndexLess(const G2 *Qvec) : Qvec(Qvec) {}
+	static int compare(const Fp2& x, const Fp2& y)
+	{
+		int c = Fp::compare(x.a, y.a);
+		if (c) return c;
+		return Fp::compare(x.b, y.b);
+	}
+	bool operator()(size_t i, size_t j) const
+	{
+		int c = compare(Qvec[i].x, Qvec[j].x);
+		if (c) return c < 0;
+		return compare(Qvec[i].y, Qvec[j].y) < 0;
+	}
+};
+
+/*
+	check prod_{i=begin}^{end-1} (prod_j e(P_ij, Q_ij))^r_i == 1
+	r_begin = 1 and the others are random securityBit-bit values
+	the pairs of the i-th equation are Pvec[offVec[i]], ..., Pvec[offVec[i + 1] - 1]
+	Qvec must be normalized
+*/
+inline bool verifyPairingEquationsRange(const G1 *Pvec, const G2 *Qvec, const size_t *offVec, size_t begin, size_t end, int securityBit)
+{
+	const size_t base = offVec[begin];
+	const size_t n = offVec[end] - base;
+	Fp12 f;
+	if (end - begin == 1) {
+		millerLoopVec(f, Pvec + base, Qvec + base, n);
+		finalExp(f, f);
+		return f.isOne();
+	}
+	size_t byteSize = securityBit / 8;
+	if (byteSize == 0 || byteSize >= Fr::getByteSize()) byteSize = Fr::getByteSize() - 1;
+	std::vector<Fr> rVec(n);
+	std::vector<size_t> idx;
+	idx.reserve(n);
+	fp::RandGen& rg = fp::RandGen::get();
+	for (size_t i = begin; i < end; i++) {
+		Fr r;
+		if (i == begin) {
+			r = 1;
+		} else {
+			uint8_t buf[sizeof(Fr)];
+			bool b;
+			rg.read(&b, buf, byteSize);
+			if (!b) return false;
+			r.setLittleEndianMod(&b, buf, byteSize);
+			if (!b) return false;
+			if (r.isZero()) r = 1;
+		}
+		for (size_t j = offVec[i]; j < offVec[i + 1]; j++) {
+			if (Qvec[j].isZero()) continue;
+			rVec[j - base] = r;
+			idx.push_back(j);
+		}
+	}
+	// fold r_i P_ij having the same Q_ij into one point
+	std::sort(idx.begin(), idx.end(), G2IndexLess(Qvec));
+	std::vector<G1> P1Vec, sumVec;
+	std::vector<Fr> r1Vec;
+	std::vector<G2> Q1Vec;
+	for (size_t i = 0; i < idx.size();) {
+		const G2& Q = Qvec[idx[i]];
+		P1Vec.clear();
+		r1Vec.clear();
+		do {
+			P1Vec.push_back(Pvec[idx[i]]);
+			r1Vec.push_back(rVec[idx[i] - base]);
+			i++;
+		} while (i < idx.size() && Qvec[idx[i]] == Q);
+		G1 S;
+		G1::mulVec(S, P1Vec.data(), r1Vec.data(), P1Vec.size());
+		sumVec.push_back(S);
+		Q1Vec.push_back(Q);
+	}
+	millerLoopVec(f, sumVec.data(), Q1Vec.data(), sumVec.size());
+	finalExp(f, f);
+	return f.isOne();
+}
+
+inline void bisectPairingEquations(bool *okVec, const G1 *Pvec, const G2 *Qvec, const size_t *offVec, size_t begin, size_t end, int securityBit)
+{
+	if (verifyPairingEquationsRange(Pvec, Qvec, offVec, begin, end, securityBit)) {
+		for (size_t i = begin; i < end; i++) okVec[i] = true;
+		return;
+	}
+	if (end - begin == 1) {
+		okVec[begin] = false;
+		return;
+	}
+	const size_t mid = (begin + end) / 2;
+	bisectPairingEquations(okVec, Pvec, Qvec, offVec, begin, mid, securityBit);
+	bisectPairingEquations(okVec, Pvec, Qvec, offVec, mid, end, securityBit);
+}
+
+} // mcl::bn::local
+
+/*
+	verify prod_{j=0}^{nVec[i]-1} e(P_ij, Q_ij) == 1 for all i = 0, ..., k-1
+	Pvec and Qvec are the concatenations of (P_i0, ..., P_i(nVec[i]-1)) and (Q_i0, ..., )
+	the equations are merged by random securityBit-bit scalars r_i into one multi-pairing
+	prod_i prod_j e(r_i P_ij, Q_ij) == 1 and r_i P_ij having the same Q_ij are folded by G1::mulVec
+	return true if all equations hold
+	(false positive probability is about 2^-securityBit if some equation does not hold)
+	if okVec is not null and the merged check fails,
+	okVec[i] is set whether the i-th equation holds by bisection
+	the elements must be in G1 and G2 (their orders are not checked)
+*/
+inline bool verifyPairingEquations(const G1 *Pvec, const G2 *Qvec, const size_t *nVec, size_t k, bool *okVec = 0, int securityBit = 128)
+{
+	std::vector<size_t> offVec(k + 1);
+	offVec[0] = 0;
+	for (size_t i = 0; i < k; i++) {
+		offVec[i + 1] = offVec[i] + nVec[i];
+	}
+	const size_t n = offVec[k];
+	std::vector<G2> Q(n);
+	G2::normalizeVec(Q.data(), Qvec, n);
+	if (k == 0 || local::verifyPairingEquationsRange(Pvec, Q.data(), offVec.data(), 0, k, securityBit)) {
+		if (okVec) {
+			for (size_t i = 0; i < k; i++) okVec[i] = true;
+		}
+		return true;
+	}
+	if (okVec) {
+		if (k == 1) {
+			okVec[0] = false;
+		} else {
+			const size_t mid = k / 2;
+			local::bisectPairingEquations(okVec, Pvec, Q.data(), offVec.data(), 0, mid, securityBit);
+			local::bisectPairingEquations(okVec, Pvec, Q.data(), offVec.data(), mid, k, securityBit);
+		}
+	}
+	return false;
+}
+#endif
+
+inline bool setMapToMode(int mode)
+{
+	return BN::nonConstParam.mapTo.setMapToMode(mode);
+}
+inline int getMapToMode()
+{
+	return BN::param.mapTo.mapToMode_;
+}
+inline void mapToG1(bool *pb, G1& P, const Fp& x) { *pb = BN::param.mapTo.calc(P, x); }
+inline void mapToG2(bool *pb, G2& P, const Fp2& x) { *pb = BN::param.mapTo.calc(P, x); }
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+inline void mapToG1(G1& P, const Fp& x)
+{
+	bool b;
+	mapToG1(&b, P, x);
+	if (!b) throw cybozu::Exception("mapToG1:bad value") << x;
+}
+inline void mapToG2(G2& P, const Fp2& x)
+{
+	bool b;
 	mapToG2(&b, P, x);
 	if (!b) throw cybozu::Exception("mapToG2:bad value") << x;
 }
@@ -2073,6 +3104,70 @@ inline void hashAndMapToG2(G2& P, const void *buf, size_t bufSize, const char *d
 {
 	BN::param.mapTo.mapTo_WB19_.msgToG2(P, buf, bufSize, dst, dstSize);
 }
+/*
+	Pvec[i] = hashAndMapToG1(msgVec[i], msgSizeVec[i]) for i = 0, ..., n-1
+	Pvec[i] are normalized
+	the inversions to normalize the points are shared among the messages
+*/
+inline void hashAndMapToG1Vec(G1 *Pvec, const void *const *msgVec, const size_t *msgSizeVec, size_t n)
+{
+	int mode = getMapToMode();
+	if (mode == MCL_MAP_TO_MODE_HASH_TO_CURVE_07) {
+		BN::param.mapTo.mapTo_WB19_.msgToG1Vec(Pvec, msgVec, msgSizeVec, n);
+		return;
+	}
+	for (size_t i = 0; i < n; i++) {
+		hashAndMapToG1(Pvec[i], msgVec[i], msgSizeVec[i]);
+	}
+	G1::normalizeVec(Pvec, Pvec, n);
+}
+namespace local {
+
+// call hashAndMapToG1Vec or hashAndMapToG2Vec for [pos, pos + n)
+template<class G>
+struct HashAndMapToVecTask {
+	void (*f)(G *Pvec, const void *const *msgVec, const size_t *msgSizeVec, size_t n);
+	G *Pvec;
+	const void *const *msgVec;
+	const size_t *msgSizeVec;
+	void operator()(size_t pos, size_t n) const { f(Pvec + pos, msgVec + pos, msgSizeVec + pos, n); }
+};
+
+} // mcl::bn::local
+
+// multi thread version of hashAndMapToG1Vec
+// the num of thread is automatically detected if cpuN = 0
+// use getThreadPool() if MCL_USE_STD_THREAD is defined
+inline void hashAndMapToG1VecMT(G1 *Pvec, const void *const *msgVec, const size_t *msgSizeVec, size_t n, size_t cpuN = 0)
+{
+	const local::HashAndMapToVecTask<G1> task = { hashAndMapToG1Vec, Pvec, msgVec, msgSizeVec };
+	local::runParallel(n, 2, cpuN, task);
+}
+/*
+	Pvec[i] = hashAndMapToG2(msgVec[i], msgSizeVec[i]) for i = 0, ..., n-1
+	Pvec[i] are normalized
+	the inversions to normalize the points are shared among the messages
+*/
+inline void hashAndMapToG2Vec(G2 *Pvec, const void *const *msgVec, const size_t *msgSizeVec, size_t n)
+{
+	int mode = getMapToMode();
+	if (mode == MCL_MAP_TO_MODE_WB19 || mode >= MCL_MAP_TO_MODE_HASH_TO_CURVE_06) {
+		BN::param.mapTo.mapTo_WB19_.msgToG2Vec(Pvec, msgVec, msgSizeVec, n);
+		return;
+	}
+	for (size_t i = 0; i < n; i++) {
+		hashAndMapToG2(Pvec[i], msgVec[i], msgSizeVec[i]);
+	}
+	G2::normalizeVec(Pvec, Pvec, n);
+}
+// multi thread version of hashAndMapToG2Vec
+// the num of thread is automatically detected if cpuN = 0
+// use getThreadPool() if MCL_USE_STD_THREAD is defined
+inline void hashAndMapToG2VecMT(G2 *Pvec, const void *const *msgVec, const size_t *msgSizeVec, size_t n, size_t cpuN = 0)
+{
+	const local::HashAndMapToVecTask<G2> task = { hashAndMapToG2Vec, Pvec, msgVec, msgSizeVec };
+	local::runParallel(n, 2, cpuN, task);
+}
 // set the default dst for G1
 // return 0 if success else -1
 inline bool setDstG1(const char *dst, size_t dstSize)
@@ -2085,6 +3180,188 @@ inline bool setDstG2(const char *dst, size_t dstSize)
 {
 	return BN::nonConstParam.mapTo.mapTo_WB19_.dstG2.set(dst, dstSize);
 }
+/*
+	streaming version of F::setHashOf (F = Fp or Fr)
+	update(msg0, size0); update(msg1, size1); ...; finalize(x);
+	x.setHashOf(msg0 | msg1 | ...)
+	finalize fails if the hash function is changed by F::setHashFunc
+	call clear() before reusing it
+*/
+template<class F>
+class SetHashOfStream {
+	enum {
+		NoHash,
+		UseSha256,
+		UseSha512
+	};
+	// Sha256 or Sha512 selected by clear() is constructed in buf_
+	union {
+		uint64_t align_;
+		char buf_[sizeof(cybozu::Sha512) > sizeof(cybozu::Sha256) ? sizeof(cybozu::Sha512) : sizeof(cybozu::Sha256)];
+	} u_;
+	int type_;
+	cybozu::Sha256& h256() { return *reinterpret_cast<cybozu::Sha256*>(u_.buf_); }
+	cybozu::Sha512& h512() { return *reinterpret_cast<cybozu::Sha512*>(u_.buf_); }
+	void destroy()
+	{
+		if (type_ == UseSha256) h256().~Sha256();
+		if (type_ == UseSha512) h512().~Sha512();
+		type_ = NoHash;
+	}
+	SetHashOfStream(const SetHashOfStream&);
+	void operator=(const SetHashOfStream&);
+public:
+	SetHashOfStream()
+		: type_(NoHash)
+	{
+		clear();
+	}
+	~SetHashOfStream()
+	{
+		destroy();
+	}
+	void clear()
+	{
+		destroy();
+		uint32_t (*hash)(void *, uint32_t, const void *, uint32_t) = F::getOp().hash;
+		if (hash == fp::sha256) {
+			new (u_.buf_) cybozu::Sha256();
+			type_ = UseSha256;
+		} else if (hash == fp::sha512) {
+			new (u_.buf_) cybozu::Sha512();
+			type_ = UseSha512;
+		}
+	}
+	void update(const void *msg, size_t msgSize)
+	{
+		if (type_ == UseSha256) {
+			h256().update(msg, msgSize);
+		} else if (type_ == UseSha512) {
+			h512().update(msg, msgSize);
+		}
+	}
+	void finalize(bool *pb, F& x)
+	{
+		uint8_t md[64];
+		size_t mdSize;
+		if (type_ == UseSha256) {
+			mdSize = h256().digest(md, sizeof(md), 0, 0);
+		} else if (type_ == UseSha512) {
+			mdSize = h512().digest(md, sizeof(md), 0, 0);
+		} else {
+			*pb = false;
+			return;
+		}
+		x.setArrayMask(md, mdSize);
+		*pb = true;
+	}
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+	void finalize(F& x)
+	{
+		bool b;
+		finalize(&b, x);
+		if (!b) throw cybozu::Exception("SetHashOfStream:finalize:hash function is changed");
+	}
+#endif
+};
+
+/*
+	streaming version of hashAndMapToG1/G2
+	update(msg0, size0); update(msg1, size1); ...; finalizeToG1(P);
+	P = hashAndMapToG1(msg0 | msg1 | ...)
+	the map-to mode is fixed by clear()
+	call clear() before reusing it
+*/
+class HashAndMapToStream {
+	int mode_;
+	bool isBLS12_;
+	ExpandMessageXmd xmd_;
+	SetHashOfStream<Fp> hashOf_;
+	// whether hashAndMapToG1/G2 uses expand_message_xmd (see hashAndMapToG1/G2)
+	bool isXmdG1() const { return mode_ == MCL_MAP_TO_MODE_HASH_TO_CURVE_07; }
+	bool isXmdG2() const { return mode_ == MCL_MAP_TO_MODE_WB19 || mode_ >= MCL_MAP_TO_MODE_HASH_TO_CURVE_06; }
+public:
+	HashAndMapToStream()
+	{
+		clear();
+	}
+	void clear()
+	{
+		mode_ = getMapToMode();
+		isBLS12_ = BN::param.isBLS12;
+		xmd_.clear();
+		hashOf_.clear();
+	}
+	/*
+		xmd_ is always updated on BLS12 for the versions with dst
+		hashOf_ is not used if both G1 and G2 use expand_message_xmd
+	*/
+	void update(const void *msg, size_t msgSize)
+	{
+		if (isBLS12_) {
+			xmd_.update(msg, msgSize);
+		}
+		if (!isXmdG1() || !isXmdG2()) {
+			hashOf_.update(msg, msgSize);
+		}
+	}
+	// fail if Fp::setHashFunc is called for the modes without expand_message_xmd
+	void finalizeToG1(bool *pb, G1& P)
+	{
+		if (isXmdG1()) {
+			const MapTo_WB19<Fp, G1, Fp2, G2>& mapTo = BN::param.mapTo.mapTo_WB19_;
+			finalizeToG1(P, mapTo.dstG1.dst, mapTo.dstG1.len);
+			*pb = true;
+			return;
+		}
+		Fp t;
+		hashOf_.finalize(pb, t);
+		if (!*pb) return;
+		mapToG1(pb, P, t);
+	}
+	void finalizeToG2(bool *pb, G2& P)
+	{
+		if (isXmdG2()) {
+			const MapTo_WB19<Fp, G1, Fp2, G2>& mapTo = BN::param.mapTo.mapTo_WB19_;
+			finalizeToG2(P, mapTo.dstG2.dst, mapTo.dstG2.len);
+			*pb = true;
+			return;
+		}
+		Fp2 t;
+		hashOf_.finalize(pb, t.a);
+		if (!*pb) return;
+		t.b.clear();
+		mapToG2(pb, P, t);
+	}
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+	void finalizeToG1(G1& P)
+	{
+		bool b;
+		finalizeToG1(&b, P);
+		if (!b) throw cybozu::Exception("HashAndMapToStream:finalizeToG1");
+	}
+	void finalizeToG2(G2& P)
+	{
+		bool b;
+		finalizeToG2(&b, P);
+		if (!b) throw cybozu::Exception("HashAndMapToStream:finalizeToG2");
+	}
+#endif
+	// P = hashAndMapToG1(msg0 | msg1 | ..., dst)
+	void finalizeToG1(G1& P, const char *dst, size_t dstSize)
+	{
+		uint8_t md[128];
+		xmd_.digest(md, sizeof(md), dst, dstSize);
+		BN::param.mapTo.mapTo_WB19_.mdToG1(P, md);
+	}
+	// P = hashAndMapToG2(msg0 | msg1 | ..., dst)
+	void finalizeToG2(G2& P, const char *dst, size_t dstSize)
+	{
+		uint8_t md[256];
+		xmd_.digest(md, sizeof(md), dst, dstSize);
+		BN::param.mapTo.mapTo_WB19_.mdToG2(P, md);
+	}
+};
 #ifndef CYBOZU_DONT_USE_STRING
 inline void hashAndMapToG1(G1& P, const std::string& str)
 {
@@ -2105,6 +3382,10 @@ inline void verifyOrderG2(bool doVerify)
 {
 	G2::setOrder(doVerify ? BN::param.r : 0);
 }
+inline void verifyOrderGT(bool doVerify)
+{
+	Fp12::setVerifyOrder(doVerify);
+}
 
 /*
 	Faster Subgroup Checks for BLS12-381
@@ -2138,6 +3419,164 @@ inline bool isValidOrderBLS12(const G1& P)
 	G1::mulGeneric(T0, T0, BN::param.mapTo.z2_);
 	return T0 == T1;
 }
+/*
+	A note on group membership tests for G1, G2 and GT on BLS pairing-friendly curves
+	Michael Scott, https://eprint.iacr.org/2021/1130
+	x is in GT if and only if
+	x is in the cyclotomic subgroup (x^(p^4) x == x^(p^2)) and x^p == x^(t-1)
+	where t-1 = z (BLS12), 6z^2 (BN)
+*/
+inline bool isValidOrderGT(const Fp12& x)
+{
+	if (x.isZero()) return false;
+	Fp12 t1, t2;
+	Fp12::Frobenius2(t1, x);
+	Fp12::Frobenius2(t2, t1);
+	t2 *= x;
+	if (t1 != t2) return false;
+	local::pow_z(t1, x);
+	if (!BN::param.isBLS12) {
+		local::pow_z(t1, t1);
+		local::fasterSqr(t2, t1);
+		t1 *= t2; // x^(3z^2)
+		local::fasterSqr(t1, t1);
+	}
+	Fp12::Frobenius(t2, x);
+	return t1 == t2;
+}
+
+/*
+	compression of GT by the torus T2(Fp6)
+	Fp12 = Fp6[w] / (w^2 - v)
+	x = a + b w such that a^2 - v b^2 = 1 (x^(p^6+1) = 1, e.g. the output of finalExp)
+	c = (1 + a) / b (c = 0 if x = 1)
+	x = (c + w) / (c - w) = ((c^2 + v) + 2c w) / (c^2 - v)
+	c^2 - v != 0 because v is not a square in Fp6
+	x must be in the cyclotomic subgroup, it is not checked
+*/
+inline void compressGT(Fp6& c, const Fp12& x)
+{
+	if (x.b.isZero()) {
+		c.clear();
+		return;
+	}
+	Fp6::inv(c, x.b);
+	Fp6 t = x.a;
+	t.a.a += Fp::one();
+	c *= t;
+}
+namespace local {
+
+// x = ((c^2 + v) + 2c w) * invD where d = c^2 - v
+inline void decompressGTAfterInv(Fp12& x, const Fp6& c, const Fp6& c2, const Fp6& invD)
+{
+	if (c.isZero()) {
+		x = 1;
+		return;
+	}
+	Fp6 t = c2;
+	t.b.a += Fp::one(); // c^2 + v
+	Fp6::mul(x.a, t, invD);
+	Fp6::add(t, c, c);
+	Fp6::mul(x.b, t, invD);
+}
+
+} // mcl::bn::local
+inline void decompressGT(Fp12& x, const Fp6& c)
+{
+	Fp6 c2, d;
+	Fp6::sqr(c2, c);
+	d = c2;
+	d.b.a -= Fp::one(); // c^2 - v
+	Fp6::inv(d, d);
+	local::decompressGTAfterInv(x, c, c2, d);
+}
+// c[i] = compressGT(x[i]) with one inversion
+inline void compressGTVec(Fp6 *c, const Fp12 *x, size_t n)
+{
+	const size_t N = 64;
+	Fp6 b[N];
+	for (size_t i = 0; i < n; i += N) {
+		const size_t m = fp::min_(n - i, N);
+		for (size_t j = 0; j < m; j++) b[j] = x[i + j].b;
+		mcl::invVec(b, b, m, N);
+		for (size_t j = 0; j < m; j++) {
+			Fp6 t = x[i + j].a;
+			t.a.a += Fp::one();
+			Fp6::mul(c[i + j], b[j], t); // c = 0 if x.b = 0
+		}
+	}
+}
+// x[i] = decompressGT(c[i]) with one inversion
+inline void decompressGTVec(Fp12 *x, const Fp6 *c, size_t n)
+{
+	const size_t N = 64;
+	Fp6 c2[N], d[N];
+	for (size_t i = 0; i < n; i += N) {
+		const size_t m = fp::min_(n - i, N);
+		for (size_t j = 0; j < m; j++) {
+			Fp6::sqr(c2[j], c[i + j]);
+			d[j] = c2[j];
+			d[j].b.a -= Fp::one();
+		}
+		mcl::invVec(d, d, m, N);
+		for (size_t j = 0; j < m; j++) {
+			local::decompressGTAfterInv(x[i + j], c[i + j], c2[j], d[j]);
+		}
+	}
+}
+/*
+	serialize x compressed by compressGT
+	the size is the half of x.serialize()
+	return written size if success else 0
+*/
+inline size_t serializeCompressedGT(void *buf, size_t maxBufSize, const Fp12& x)
+{
+	Fp6 c;
+	compressGT(c, x);
+	return c.serialize(buf, maxBufSize);
+}
+/*
+	deserialize x serialized by serializeCompressedGT
+	the order of x is verified if verifyOrderGT(true) as GT::deserialize
+	return read size if success else 0
+*/
+inline size_t deserializeCompressedGT(Fp12& x, const void *buf, size_t bufSize)
+{
+	Fp6 c;
+	const size_t n = c.deserialize(buf, bufSize);
+	if (n == 0) return 0;
+	decompressGT(x, c);
+	if (Fp12::verifyOrder_ && !x.isValidOrder()) return 0;
+	return n;
+}
+/*
+	deserialize x[0], ..., x[n-1] from the concatenation of the outputs of serializeCompressedGT
+	with one inversion per 64 elements
+	return read size if success else 0
+*/
+inline size_t deserializeCompressedGTVec(Fp12 *x, const void *buf, size_t bufSize, size_t n)
+{
+	const size_t N = 64;
+	Fp6 c[N];
+	const uint8_t *src = (const uint8_t*)buf;
+	size_t pos = 0;
+	for (size_t i = 0; i < n; i += N) {
+		const size_t m = fp::min_(n - i, N);
+		for (size_t j = 0; j < m; j++) {
+			const size_t r = c[j].deserialize(src + pos, bufSize - pos);
+			if (r == 0) return 0;
+			pos += r;
+		}
+		decompressGTVec(x + i, c, m);
+		if (Fp12::verifyOrder_) {
+			for (size_t j = 0; j < m; j++) {
+				if (!x[i + j].isValidOrder()) return 0;
+			}
+		}
+	}
+	return pos;
+}
 
 // backward compatibility
 using mcl::CurveParam;
@@ -2198,6 +3637,8 @@ inline void init(bool *pb, const mcl::CurveParam& cp = mcl::BN254, fp::Mode mode
 		G1::setVerifyOrderFunc(isValidOrderBLS12);
 		G2::setVerifyOrderFunc(isValidOrderBLS12);
 	}
+	verifyOrderGT(false);
+	Fp12::setVerifyOrderFunc(isValidOrderGT);
 	*pb = true;
 }
 
@@ -2231,6 +3672,7 @@ inline void initG1only(bool *pb, const mcl::EcParam& para)
 	G1::setMulVecGLV(0);
 	G2::setMulVecGLV(0);
 	Fp12::setPowVecGLV(0);
+	Fp12::setVerifyOrderFunc(0);
 	BN::nonConstParam.initG1only(pb, para);
 	if (!*pb) return;
 	G1::setCompressedExpression();
@@ -2250,5 +3692,30 @@ inline void mulByCofactorBLS12fast(mcl::MCL_NAMESPACE_BN::G2& Q, const mcl::MCL_
 {
 	mcl::MCL_NAMESPACE_BN::BN::param.mapTo.mulByCofactorBLS12fast(Q, P);
 }
+/*
+	Q = (1 - z)P (h_eff of G1 in hash-to-curve)
+	abs(z)P is computed by the NAF of abs(z) instead of mulGeneric
+*/
+template<>
+inline void mulByCofactorBLS12fast(mcl::MCL_NAMESPACE_BN::G1& Q, const mcl::MCL_NAMESPACE_BN::G1& P)
+{
+	typedef mcl::MCL_NAMESPACE_BN::G1 G1;
+	const mcl::MCL_NAMESPACE_BN::local::Param& param = mcl::MCL_NAMESPACE_BN::BN::param;
+	const mcl::MCL_NAMESPACE_BN::local::SignVec& naf = param.zReplTbl;
+	G1 T = P;
+	for (size_t i = 1; i < naf.size(); i++) {
+		G1::dbl(T, T);
+		if (naf[i] > 0) {
+			T += P;
+		} else if (naf[i] < 0) {
+			T -= P;
+		}
+	}
+	if (param.isNegative) {
+		G1::add(Q, P, T);
+	} else {
+		G1::sub(Q, P, T);
+	}
+}
 } } // mcl::local
 #endif
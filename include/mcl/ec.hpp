@@ -15,7 +15,9 @@
 	#pragma warning(push)
 	#pragma warning(disable : 4458)
 #endif
-#ifdef MCL_USE_OMP
+#ifdef MCL_USE_STD_THREAD
+#include <mcl/thread_pool.hpp>
+#elif defined(MCL_USE_OMP)
 #include <omp.h>
 #endif
 
@@ -81,24 +83,19 @@ bool get_a_flag(const mcl::Fp2T<F>& x)
 	w : window size
 */
 template<class GLV, class G>
-void mulGLV_CT(G& Q, const G& P, const void *yVec, fp::getMpzAtType getMpzAt)
+void mulGLV_CT(G& Q, const G& P, const void *yVec, fp::getUnitAtType getUnitAt)
 {
 	const size_t w = 4;
 	typedef typename GLV::Fr F;
 	const int splitN = GLV::splitN;
 	const size_t tblSize = 1 << w;
+	const size_t next = F::getUnitSize();
 	G tbl[splitN][tblSize];
 	bool negTbl[splitN];
-	mpz_class u[splitN], y;
-	getMpzAt(y, yVec, 0);
-	GLV::split(u, y);
+	Unit u[splitN][F::maxSize], y[F::maxSize];
+	getUnitAt(y, yVec, 0);
+	GLV::split(u[0], F::maxSize, negTbl, y);
 	for (int i = 0; i < splitN; i++) {
-		if (u[i] < 0) {
-			gmp::neg(u[i], u[i]);
-			negTbl[i] = true;
-		} else {
-			negTbl[i] = false;
-		}
 		tbl[i][0].clear();
 	}
 	tbl[0][1] = P;
@@ -123,7 +120,7 @@ void mulGLV_CT(G& Q, const G& P, const void *yVec, fp::getMpzAtType getMpzAt)
 		size_t maxBitSize = 0;
 		fp::BitIterator<Unit> itr[splitN];
 		for (int i = 0; i < splitN; i++) {
-			itr[i].init(gmp::getUnit(u[i]), gmp::getUnitSize(u[i]));
+			itr[i].init(u[i], next);
 			size_t bitSize = itr[i].getBitSize();
 			if (bitSize > maxBitSize) maxBitSize = bitSize;
 		}
@@ -797,8 +794,8 @@ inline size_t argminForMulVec(size_t n)
 }
 
 #ifndef MCL_MAX_N_TO_USE_STACK_FOR_MUL_VEC
-	// use (1 << argminForMulVec(n)) * sizeof(G) bytes stack + alpha
-	// about 18KiB (G1) or 36KiB (G2) for n = 1024
+	// use (1 << (argminForMulVec(n) - 1)) * sizeof(G) + n bytes stack + alpha
+	// about 9KiB (G1) or 18KiB (G2) for n = 1024
 	// you can decrease this value but this algorithm is slow if n < 256
 	#define MCL_MAX_N_TO_USE_STACK_FOR_MUL_VEC 1024
 #endif
@@ -808,6 +805,11 @@ inline size_t argminForMulVec(size_t n)
 	return numbers of done, which may be smaller than n if malloc fails
 	@note xVec may be normlized
 	fast for n >= 256
+
+	signed-digit window method
+	each c-bit window v of yVec[i] (plus the carry from the lower window) is recoded to
+	d = v if v <= 2^(c-1) else v - 2^c (and carry 1 to the next window)
+	so tbl has only 2^(c-1) buckets and xVec[i] is subtracted if d < 0
 */
 template<class G>
 size_t mulVecCore(G& z, G *xVec, const Unit *yVec, size_t yUnitSize, size_t next, size_t n, bool doNormalize = true)
@@ -824,39 +826,55 @@ size_t mulVecCore(G& z, G *xVec, const Unit *yVec, size_t yUnitSize, size_t next
 	size_t c, tblN;
 	G *tbl_ = 0; // malloc is used if tbl_ != 0
 	G *tbl = 0;
+	uint8_t *carry = 0; // carry[i] : carry of yVec[i] to the next window
 
 	// if n is large then try to use malloc
 	if (n > MCL_MAX_N_TO_USE_STACK_FOR_MUL_VEC) {
 		c = argminForMulVec(n);
-		tblN = (1 << c) - 1;
-		tbl_ = (G*)malloc(sizeof(G) * tblN);
+		tblN = size_t(1) << (c - 1);
+		tbl_ = (G*)malloc(sizeof(G) * tblN + n);
 		if (tbl_) {
 			tbl = tbl_;
+			carry = (uint8_t*)(tbl_ + tblN);
 			goto main;
 		}
 	}
 	// n is small or malloc fails so use stack
 	if (n > MCL_MAX_N_TO_USE_STACK_FOR_MUL_VEC) n = MCL_MAX_N_TO_USE_STACK_FOR_MUL_VEC;
 	c = argminForMulVec(n);
-	tblN = (1 << c) - 1;
+	tblN = size_t(1) << (c - 1);
 	tbl = (G*)CYBOZU_ALLOCA(sizeof(G) * tblN);
+	carry = (uint8_t*)CYBOZU_ALLOCA(n);
 	// keep tbl_ = 0
 main:
 	const size_t maxBitSize = sizeof(Unit) * yUnitSize * 8;
+	// the top window has at most c-1 bits (or only the carry) so it never carries
 	const size_t winN = maxBitSize / c + 1;
+	const Unit mask = (Unit(1) << c) - 1;
+	const Unit half = Unit(1) << (c - 1);
 	G *win = (G*)CYBOZU_ALLOCA(sizeof(G) * winN);
 
 	// about 10% faster
 	if (doNormalize) G::normalizeVec(xVec, xVec, n);
 
+	memset(carry, 0, n);
 	for (size_t w = 0; w < winN; w++) {
 		for (size_t i = 0; i < tblN; i++) {
 			tbl[i].clear();
 		}
 		for (size_t i = 0; i < n; i++) {
-			Unit v = fp::getUnitAt(yVec + next * i, yUnitSize, c * w) & tblN;
-			if (v) {
-				tbl[v - 1] += xVec[i];
+			Unit v = (fp::getUnitAt(yVec + next * i, yUnitSize, c * w) & mask) + carry[i];
+			if (v > half) {
+				carry[i] = 1;
+				v = mask + 1 - v; // v = -d
+				if (v) {
+					tbl[v - 1] -= xVec[i];
+				}
+			} else {
+				carry[i] = 0;
+				if (v) {
+					tbl[v - 1] += xVec[i];
+				}
 			}
 		}
 		G sum;
@@ -877,31 +895,426 @@ main:
 	if (tbl_) free(tbl_);
 	return n;
 }
+#ifndef MCL_MIN_N_TO_USE_BATCH_AFFINE
+	// mulVecLong uses mulVecCoreBatchAffine if n >= MCL_MIN_N_TO_USE_BATCH_AFFINE
+	#define MCL_MIN_N_TO_USE_BATCH_AFFINE 16384
+#endif
+
+namespace local {
+
+/*
+	affine buckets for mulVecCoreBatchAffine
+	tbl[b] is an affine point (z = 1) or zero
+	tbl[b] += P are collected up to maxBatchN entries and done by affine addition
+	with one shared inversion (Montgomery trick)
+	P which conflicts with a bucket in the current batch waits in queue_
+*/
+template<class G>
+class BatchAffineBucket {
+	typedef typename G::Fp F;
+	static const size_t maxBatchN = 256;
+	struct Entry {
+		G *B;
+		const G *P;
+		bool negP;
+		bool isDbl;
+	};
+	struct Item {
+		const G *P;
+		size_t b;
+		bool negP;
+	};
+	G *tbl_;
+	uint8_t *busy_; // busy_[b] = 1 if tbl_[b] is in the current batch
+	F den_[maxBatchN];
+	Entry entry_[maxBatchN];
+	size_t batchN_;
+	Item queue_[maxBatchN];
+	size_t queueN_;
+	BatchAffineBucket(const BatchAffineBucket&);
+	void operator=(const BatchAffineBucket&);
+	// assume !busy_[b]
+	void push(size_t b, const G& P, bool negP)
+	{
+		G& B = tbl_[b];
+		if (B.isZero()) {
+			if (negP) {
+				G::neg(B, P);
+			} else {
+				B = P;
+			}
+			return;
+		}
+		Entry& e = entry_[batchN_];
+		if (B.x == P.x) {
+			F Py;
+			if (negP) {
+				F::neg(Py, P.y);
+			} else {
+				Py = P.y;
+			}
+			if (B.y != Py || Py.isZero()) {
+				B.clear();
+				return;
+			}
+			F::add(den_[batchN_], Py, Py);
+			e.isDbl = true;
+		} else {
+			F::sub(den_[batchN_], P.x, B.x);
+			e.isDbl = false;
+		}
+		e.B = &B;
+		e.P = &P;
+		e.negP = negP;
+		busy_[b] = 1;
+		batchN_++;
+		if (batchN_ == maxBatchN) flush();
+	}
+	void flush()
+	{
+		if (batchN_ == 0) return;
+		invVec(den_, den_, batchN_, maxBatchN);
+		for (size_t i = 0; i < batchN_; i++) {
+			const Entry& e = entry_[i];
+			G& B = *e.B;
+			const G& P = *e.P;
+			F L, t;
+			if (e.isDbl) {
+				// L = (3x^2 + a) / 2y
+				F::sqr(t, B.x);
+				F::add(L, t, t);
+				L += t;
+				L += G::a_;
+			} else {
+				// L = (Py - By) / (Px - Bx)
+				if (e.negP) {
+					F::add(L, P.y, B.y);
+					F::neg(L, L);
+				} else {
+					F::sub(L, P.y, B.y);
+				}
+			}
+			L *= den_[i];
+			F::sqr(t, L);
+			t -= B.x;
+			t -= P.x;
+			F::sub(B.z, B.x, t); // use B.z as a temporary
+			B.z *= L;
+			F::sub(B.y, B.z, B.y);
+			B.x = t;
+			B.z = 1;
+			busy_[e.B - tbl_] = 0;
+		}
+		batchN_ = 0;
+	}
+	void processQueue()
+	{
+		size_t i = queueN_;
+		while (i > 0) {
+			i--;
+			const Item it = queue_[i];
+			if (busy_[it.b]) continue;
+			queue_[i] = queue_[queueN_ - 1];
+			queueN_--;
+			push(it.b, *it.P, it.negP);
+		}
+	}
+public:
+	BatchAffineBucket(G *tbl, uint8_t *busy)
+		: tbl_(tbl)
+		, busy_(busy)
+		, batchN_(0)
+		, queueN_(0)
+	{
+	}
+	// tbl[b] += negP ? -P : P
+	void add(size_t b, const G& P, bool negP)
+	{
+		if (P.isZero()) return;
+		if (busy_[b]) {
+			Item& it = queue_[queueN_++];
+			it.P = &P;
+			it.b = b;
+			it.negP = negP;
+			if (queueN_ == maxBatchN) {
+				flush();
+				processQueue();
+			}
+			return;
+		}
+		push(b, P, negP);
+	}
+	// finish all pending additions
+	void finish()
+	{
+		while (batchN_ > 0 || queueN_ > 0) {
+			flush();
+			processQueue();
+		}
+	}
+};
+
+// buckets of Jacobi/Proj points with the same interface as BatchAffineBucket
+template<class G>
+class JacobiBucket {
+	G *tbl_;
+public:
+	explicit JacobiBucket(G *tbl) : tbl_(tbl) {}
+	void add(size_t b, const G& P, bool negP)
+	{
+		if (negP) {
+			tbl_[b] -= P;
+		} else {
+			tbl_[b] += P;
+		}
+	}
+	void finish() {}
+};
+
+} // mcl::ec::local
+
+/*
+	same as mulVecCore but the buckets are affine points
+	and the additions to them are done by affine addition sharing one inversion per batch
+	xVec must be normalized if doNormalize = false
+	G must be EcT
+*/
+template<class G>
+size_t mulVecCoreBatchAffine(G& z, G *xVec, const Unit *yVec, size_t yUnitSize, size_t next, size_t n, bool doNormalize = true)
+{
+	if (n <= 1) return mulVecCore(z, xVec, yVec, yUnitSize, next, n, doNormalize);
+	// an affine addition is cheaper than a Jacobian one so use a larger window than mulVecCore
+	const size_t c = argminForMulVec(n) + 1;
+	const size_t tblN = size_t(1) << (c - 1);
+	G *tbl = (G*)malloc(sizeof(G) * tblN + tblN + n);
+	if (tbl == 0) return mulVecCore(z, xVec, yVec, yUnitSize, next, n, doNormalize);
+	uint8_t *busy = (uint8_t*)(tbl + tblN);
+	uint8_t *carry = busy + tblN;
+	const size_t maxBitSize = sizeof(Unit) * yUnitSize * 8;
+	const size_t winN = maxBitSize / c + 1;
+	const Unit mask = (Unit(1) << c) - 1;
+	const Unit half = Unit(1) << (c - 1);
+	G *win = (G*)CYBOZU_ALLOCA(sizeof(G) * winN);
+
+	if (doNormalize) G::normalizeVec(xVec, xVec, n);
+
+	memset(busy, 0, tblN);
+	memset(carry, 0, n);
+	local::BatchAffineBucket<G> bucket(tbl, busy);
+	for (size_t w = 0; w < winN; w++) {
+		for (size_t i = 0; i < tblN; i++) {
+			tbl[i].clear();
+		}
+		for (size_t i = 0; i < n; i++) {
+			Unit v = (fp::getUnitAt(yVec + next * i, yUnitSize, c * w) & mask) + carry[i];
+			if (v > half) {
+				carry[i] = 1;
+				v = mask + 1 - v;
+				if (v) bucket.add(v - 1, xVec[i], true);
+			} else {
+				carry[i] = 0;
+				if (v) bucket.add(v - 1, xVec[i], false);
+			}
+		}
+		bucket.finish();
+		G sum;
+		sum.clear();
+		win[w].clear();
+		for (size_t i = 0; i < tblN; i++) {
+			sum += tbl[tblN - 1 - i];
+			win[w] += sum;
+		}
+	}
+	z.clear();
+	for (size_t w = 0; w < winN; w++) {
+		for (size_t i = 0; i < c; i++) {
+			G::dbl(z, z);
+		}
+		z += win[winN - 1 - w];
+	}
+	free(tbl);
+	return n;
+}
+
+namespace local {
+
+// whether G has affine coordinates (specialized for EcT)
+template<class G>
+struct CanUseBatchAffine {
+	static const bool value = false;
+};
+
+template<class G, bool useBatchAffine = CanUseBatchAffine<G>::value>
+struct MulVecCoreSelector {
+	static size_t mulVecCore(G& z, G *xVec, const Unit *yVec, size_t yUnitSize, size_t next, size_t n, bool doNormalize)
+	{
+		return mcl::ec::mulVecCore(z, xVec, yVec, yUnitSize, next, n, doNormalize);
+	}
+};
+
+template<class G>
+struct MulVecCoreSelector<G, true> {
+	static size_t mulVecCore(G& z, G *xVec, const Unit *yVec, size_t yUnitSize, size_t next, size_t n, bool doNormalize)
+	{
+		if (n >= MCL_MIN_N_TO_USE_BATCH_AFFINE) {
+			return mcl::ec::mulVecCoreBatchAffine(z, xVec, yVec, yUnitSize, next, n, doNormalize);
+		}
+		return mcl::ec::mulVecCore(z, xVec, yVec, yUnitSize, next, n, doNormalize);
+	}
+};
+
+} // mcl::ec::local
+
 template<class G>
 void mulVecLong(G& z, G *xVec, const Unit *yVec, size_t yUnitSize, size_t next, size_t n, bool doNormalize = true)
 {
-	size_t done = mulVecCore(z, xVec, yVec, yUnitSize, next, n, doNormalize);
+	typedef local::MulVecCoreSelector<G> Selector;
+	size_t done = Selector::mulVecCore(z, xVec, yVec, yUnitSize, next, n, doNormalize);
 	if (done == n) return;
 	do {
 		xVec += done;
 		yVec += next * done;
 		n -= done;
 		G t;
-		done = mulVecCore(t, xVec, yVec, yUnitSize, next, n, doNormalize);
+		done = Selector::mulVecCore(t, xVec, yVec, yUnitSize, next, n, doNormalize);
 		z += t;
 	} while (done < n);
 }
 
+#ifndef MCL_MAX_C_FOR_MUL_VEC_STREAM
+	// the buckets of mulVecStream and mulVecGLVstream use about (bitSize / c + 1) * 2^(c-1) * sizeof(G) bytes
+	#define MCL_MAX_C_FOR_MUL_VEC_STREAM 16
+#endif
+
+namespace local {
+
+/*
+	add xVec[i] to tbl[|d_i| - 1] with the sign of d_i
+	where d_i is the w-th c-bit signed digit of yVec[i] (see mulVecCore)
+	carry[i] is the carry of the w-th window
+	and updated to the one of the (w+1)-th window
+*/
+template<class G, class Bucket>
+void addWindowToBucket(Bucket& bucket, uint8_t *carry, const G *xVec, const Unit *yVec, size_t yUnitSize, size_t next, size_t n, size_t c, size_t w)
+{
+	const Unit mask = (Unit(1) << c) - 1;
+	const Unit half = Unit(1) << (c - 1);
+	for (size_t i = 0; i < n; i++) {
+		Unit v = (fp::getUnitAt(yVec + next * i, yUnitSize, c * w) & mask) + carry[i];
+		const bool negP = v > half;
+		carry[i] = negP;
+		if (negP) v = mask + 1 - v;
+		if (v) bucket.add(v - 1, xVec[i], negP);
+	}
+	bucket.finish();
+}
+
+template<class G, bool canUseBatchAffine = CanUseBatchAffine<G>::value>
+struct AddWindowSelector {
+	static void add(G *tbl, uint8_t *, bool, uint8_t *carry, const G *xVec, const Unit *yVec, size_t yUnitSize, size_t next, size_t n, size_t c, size_t w)
+	{
+		JacobiBucket<G> bucket(tbl);
+		addWindowToBucket(bucket, carry, xVec, yVec, yUnitSize, next, n, c, w);
+	}
+};
+
+template<class G>
+struct AddWindowSelector<G, true> {
+	static void add(G *tbl, uint8_t *busy, bool useBatchAffine, uint8_t *carry, const G *xVec, const Unit *yVec, size_t yUnitSize, size_t next, size_t n, size_t c, size_t w)
+	{
+		if (useBatchAffine) {
+			BatchAffineBucket<G> bucket(tbl, busy);
+			addWindowToBucket(bucket, carry, xVec, yVec, yUnitSize, next, n, c, w);
+		} else {
+			JacobiBucket<G> bucket(tbl);
+			addWindowToBucket(bucket, carry, xVec, yVec, yUnitSize, next, n, c, w);
+		}
+	}
+};
+
+/*
+	buckets of all windows
+	xVec[i] * yVec[i] are added chunk by chunk and z is computed at the end
+*/
+template<class G>
+class WindowBuckets {
+	G *tbl_;
+	uint8_t *busy_;
+	uint8_t *carry_;
+	size_t c_;
+	size_t winN_;
+	size_t tblN_;
+	bool useBatchAffine_;
+public:
+	// byte size of buf for init where add() is called with n <= maxN
+	static size_t getBufSize(size_t c, size_t winN, size_t maxN)
+	{
+		return (sizeof(G) + 1) * (winN << (c - 1)) + maxN;
+	}
+	/*
+		buf must have getBufSize(c, winN, maxN) bytes
+		useBatchAffine can be true if G is EcT
+	*/
+	void init(void *buf, size_t c, size_t winN, bool useBatchAffine)
+	{
+		c_ = c;
+		winN_ = winN;
+		tblN_ = size_t(1) << (c - 1);
+		useBatchAffine_ = useBatchAffine;
+		const size_t bucketN = winN * tblN_;
+		tbl_ = (G*)buf;
+		busy_ = (uint8_t*)(tbl_ + bucketN);
+		carry_ = busy_ + bucketN;
+		for (size_t i = 0; i < bucketN; i++) {
+			tbl_[i].clear();
+		}
+		memset(busy_, 0, bucketN);
+	}
+	/*
+		add sum_{i=0}^{n-1} xVec[i] * yVec[i] where yVec[i] < 2^(c * winN - 1)
+		xVec must be normalized if useBatchAffine
+	*/
+	void add(const G *xVec, const Unit *yVec, size_t yUnitSize, size_t next, size_t n)
+	{
+		memset(carry_, 0, n);
+		for (size_t w = 0; w < winN_; w++) {
+			AddWindowSelector<G>::add(tbl_ + w * tblN_, busy_ + w * tblN_, useBatchAffine_, carry_, xVec, yVec, yUnitSize, next, n, c_, w);
+		}
+	}
+	void get(G& z) const
+	{
+		z.clear();
+		for (size_t w = 0; w < winN_; w++) {
+			for (size_t i = 0; i < c_; i++) {
+				G::dbl(z, z);
+			}
+			const G *B = tbl_ + (winN_ - 1 - w) * tblN_;
+			G sum, win;
+			sum.clear();
+			win.clear();
+			for (size_t i = 0; i < tblN_; i++) {
+				sum += B[tblN_ - 1 - i];
+				win += sum;
+			}
+			z += win;
+		}
+	}
+};
+
+} // mcl::ec::local
+
 // for n >= 128
+// xVec must be normalized if isNormalized is true
 template<class GLV, class G>
-bool mulVecGLVlarge(G& z, const G *xVec, const void *yVec, size_t n, fp::getMpzAtType getMpzAt)
+bool mulVecGLVlarge(G& z, const G *xVec, const void *yVec, size_t n, fp::getUnitAtType getUnitAt, bool isNormalized = false)
 {
 	const int splitN = GLV::splitN;
 	assert(n > 0);
 	typedef typename GLV::Fr F;
 	typedef mcl::Unit Unit;
 	const size_t next = F::getUnitSize();
-	mpz_class u[splitN], y;
+	Unit y[F::maxSize];
+	bool neg[splitN];
 
 	const size_t tblByteSize = sizeof(G) * splitN * n;
 	const size_t ypByteSize = sizeof(Unit) * next * splitN * n;
@@ -910,24 +1323,23 @@ bool mulVecGLVlarge(G& z, const G *xVec, const void *yVec, size_t n, fp::getMpzA
 
 	Unit *yp = (Unit *)(tbl + splitN * n);
 
-	G::normalizeVec(tbl, xVec, n);
+	if (isNormalized) {
+		for (size_t i = 0; i < n; i++) {
+			tbl[i] = xVec[i];
+		}
+	} else {
+		G::normalizeVec(tbl, xVec, n);
+	}
 	for (int i = 1; i < splitN; i++) {
 		for (size_t j = 0; j < n; j++) {
 			GLV::mulLambda(tbl[i * n + j], tbl[(i - 1) * n + j]);
 		}
 	}
 	for (size_t i = 0; i < n; i++) {
-		getMpzAt(y, yVec, i);
-		GLV::split(u, y);
-		for (size_t j = 0; j < splitN; j++) {
-			size_t idx = j * n + i;
-			if (u[j] < 0) {
-				u[j] = -u[j];
-				G::neg(tbl[idx], tbl[idx]);
-			}
-			bool b;
-			mcl::gmp::getArray(&b, &yp[idx * next], next, u[j]);
-			assert(b); (void)b;
+		getUnitAt(y, yVec, i);
+		GLV::split(&yp[i * next], n * next, neg, y);
+		for (int j = 0; j < splitN; j++) {
+			if (neg[j]) G::neg(tbl[j * n + i], tbl[j * n + i]);
 		}
 	}
 	mulVecLong(z, tbl, yp, next, next, n * splitN, false);
@@ -935,6 +1347,61 @@ bool mulVecGLVlarge(G& z, const G *xVec, const void *yVec, size_t n, fp::getMpzA
 	return true;
 }
 
+/*
+	same as mulVecGLVlarge but without splitN * n copies of xVec
+	lambda^j xVec[i] and the splitted scalars are made chunk by chunk and added to the buckets of all windows
+	xVec must be normalized if isNormalized is true
+*/
+template<class GLV, class G>
+bool mulVecGLVstream(G& z, const G *xVec, const void *yVec, size_t n, fp::getUnitAtType getUnitAt, bool isNormalized = false)
+{
+	const int splitN = GLV::splitN;
+	typedef typename GLV::Fr F;
+	const size_t next = F::getUnitSize();
+	Unit y[F::maxSize];
+	bool neg[splitN];
+	// the splitted scalars have at most bitSize / splitN + splitN bits (the same bound as NafArray of mulVecGLVsmall)
+	const size_t maxBit = F::getOp().bitSize / splitN + splitN;
+	const size_t c = fp::min_<size_t>(argminForMulVec(n * splitN), MCL_MAX_C_FOR_MUL_VEC_STREAM);
+	const size_t winN = maxBit / c + 1;
+	const bool useBatchAffine = local::CanUseBatchAffine<G>::value && n * splitN >= MCL_MIN_N_TO_USE_BATCH_AFFINE;
+	// a large chunk reduces the inversions of BatchAffineBucket
+	const size_t chunkN = fp::min_<size_t>(n, useBatchAffine ? 1024 : 256);
+	const size_t bucketSize = local::WindowBuckets<G>::getBufSize(c, winN, splitN * chunkN);
+	G *tbl = (G*)malloc(bucketSize + (sizeof(G) + sizeof(Unit) * next) * splitN * chunkN);
+	if (tbl == 0) return false;
+	Unit *yp = (Unit*)(tbl + splitN * chunkN);
+	local::WindowBuckets<G> buckets;
+	buckets.init(yp + next * splitN * chunkN, c, winN, useBatchAffine);
+	for (size_t pos = 0; pos < n; pos += chunkN) {
+		const size_t m = fp::min_<size_t>(n - pos, chunkN);
+		if (isNormalized) {
+			for (size_t i = 0; i < m; i++) {
+				tbl[i] = xVec[pos + i];
+			}
+		} else {
+			G::normalizeVec(tbl, xVec + pos, m);
+		}
+		for (int j = 1; j < splitN; j++) {
+			for (size_t i = 0; i < m; i++) {
+				GLV::mulLambda(tbl[j * m + i], tbl[(j - 1) * m + i]);
+			}
+		}
+		for (size_t i = 0; i < m; i++) {
+			getUnitAt(y, yVec, pos + i);
+			GLV::split(&yp[i * next], m * next, neg, y);
+			for (int j = 0; j < splitN; j++) {
+				assert(bint::getRealSize(&yp[(j * m + i) * next], next) <= (maxBit + UnitBitSize - 1) / UnitBitSize && fp::getUnitAt(&yp[(j * m + i) * next], next, maxBit) == 0);
+				if (neg[j]) G::neg(tbl[j * m + i], tbl[j * m + i]);
+			}
+		}
+		buckets.add(tbl, yp, next, next, m * splitN);
+	}
+	buckets.get(z);
+	free(tbl);
+	return true;
+}
+
 template<class G>
 bool mulSmallInt(G& z, const G& x, Unit y, bool isNegative)
 {
@@ -1058,6 +1525,52 @@ bool mulSmallInt(G& z, const G& x, Unit y, bool isNegative)
 	return true;
 }
 
+namespace local {
+
+/*
+	same as gmp::getNAFwidth for x[n] (negated if negative) without mpz_class
+*/
+template<class Vec>
+void getNAFwidth(bool *pb, Vec& naf, const Unit *x, size_t n, size_t w, bool negative)
+{
+	assert(w > 0);
+	*pb = true;
+	naf.clear();
+	const int signedMaxW = 1 << (w - 1);
+	const int maxW = signedMaxW * 2;
+	const Unit maskW = Unit(maxW - 1);
+	n = bint::getRealSize(x, n);
+	const size_t bitSize = n * UnitBitSize;
+	size_t pos = 0;
+	size_t zeroNum = 0;
+	Unit carry = 0;
+	while (pos < bitSize || carry) {
+		const Unit s = (fp::getUnitAt(x, n, pos) & 1) + carry;
+		if ((s & 1) == 0) {
+			carry = s >> 1;
+			pos++;
+			zeroNum++;
+			continue;
+		}
+		for (size_t i = 0; i < zeroNum; i++) {
+			naf.push(pb, 0);
+			if (!*pb) return;
+		}
+		int v = int((fp::getUnitAt(x, n, pos) & maskW) + carry);
+		carry = 0;
+		if (v & signedMaxW) {
+			carry = 1;
+			v -= maxW;
+		}
+		naf.push(pb, typename Vec::value_type(negative ? -v : v));
+		if (!*pb) return;
+		pos += w;
+		zeroNum = w - 1;
+	}
+}
+
+} // mcl::ec::local
+
 /*
 	z += xVec[i] * yVec[i] for i = 0, ..., min(N, n)
 	splitN = 2(G1) or 4(G2)
@@ -1065,31 +1578,36 @@ bool mulSmallInt(G& z, const G& x, Unit y, bool isNegative)
 	for n <= 16
 */
 template<class GLV, class G, int w>
-static void mulVecGLVsmall(G& z, const G *xVec, const void* yVec, size_t n, fp::getMpzAtType getMpzAt)
+static void mulVecGLVsmall(G& z, const G *xVec, const void* yVec, size_t n, fp::getUnitAtType getUnitAt)
 {
+	typedef typename GLV::Fr F;
+	const size_t next = F::getUnitSize();
 	assert(n <= mcl::fp::maxMulVecNGLV);
+	if (n == 0) {
+		z.clear();
+		return;
+	}
 	const int splitN = GLV::splitN;
 	const size_t tblSize = 1 << (w - 2);
 	typedef mcl::FixedArray<int8_t, sizeof(typename GLV::Fr) * 8 / splitN + splitN> NafArray;
 	NafArray (*naf)[splitN] = (NafArray (*)[splitN])CYBOZU_ALLOCA(sizeof(NafArray) * n * splitN);
 	// layout tbl[splitN][n][tblSize];
 	G (*tbl)[tblSize] = (G (*)[tblSize])CYBOZU_ALLOCA(sizeof(G) * splitN * n * tblSize);
-	mpz_class u[splitN], y;
+	Unit u[splitN][F::maxSize], y[F::maxSize];
+	bool neg[splitN];
 	size_t maxBit = 0;
 
 	for (size_t i = 0; i < n; i++) {
-		getMpzAt(y, yVec, i);
+		getUnitAt(y, yVec, i);
 		if (n == 1) {
-			const Unit *y0 = mcl::gmp::getUnit(y);
-			size_t yn = mcl::gmp::getUnitSize(y);
-			yn = bint::getRealSize(y0, yn);
-			if (yn <= 1 && mulSmallInt(z, xVec[0], *y0, false)) return;
+			const size_t yn = bint::getRealSize(y, next);
+			if (yn <= 1 && mulSmallInt(z, xVec[0], yn == 0 ? 0 : y[0], false)) return;
 		}
-		GLV::split(u, y);
+		GLV::split(u[0], F::maxSize, neg, y);
 
 		for (int j = 0; j < splitN; j++) {
 			bool b;
-			gmp::getNAFwidth(&b, naf[i][j], u[j], w);
+			local::getNAFwidth(&b, naf[i][j], u[j], next, w, neg[j]);
 			assert(b); (void)b;
 			if (naf[i][j].size() > maxBit) maxBit = naf[i][j].size();
 		}
@@ -1126,22 +1644,184 @@ static void mulVecGLVsmall(G& z, const G *xVec, const void* yVec, size_t n, fp::
 
 // return false if malloc fails or n is not in a target range
 template<class GLV, class G, class F>
-bool mulVecGLVT(G& z, const G *xVec, const void *yVec, size_t n, fp::getMpzAtType getMpzAt, fp::getUnitAtType /*getUnitAt*/, bool constTime = false)
+bool mulVecGLVT(G& z, const G *xVec, const void *yVec, size_t n, fp::getMpzAtType getMpzAt, fp::getUnitAtType getUnitAt, bool constTime = false, bool isNormalized = false)
 {
+	if (getUnitAt != fp::getUnitAtT<F>) {
+		// yVec is not an array of F (e.g. Fp), so reduce it mod r
+		F *y = (F*)malloc(sizeof(F) * n);
+		if (y == 0) return false;
+		mpz_class t;
+		bool b = true;
+		for (size_t i = 0; i < n && b; i++) {
+			getMpzAt(t, yVec, i);
+			y[i].setArrayMod(&b, gmp::getUnit(t), gmp::getUnitSize(t));
+		}
+		if (b) b = mulVecGLVT<GLV, G, F>(z, xVec, y, n, fp::getMpzAtT<F>, fp::getUnitAtT<F>, constTime, isNormalized);
+		free(y);
+		return b;
+	}
 	if (n == 1 && constTime) {
-		local::mulGLV_CT<GLV, G>(z, xVec[0], yVec, getMpzAt);
+		local::mulGLV_CT<GLV, G>(z, xVec[0], yVec, getUnitAt);
 		return true;
 	}
 	if (n <= mcl::fp::maxMulVecNGLV) {
-		mulVecGLVsmall<GLV, G, 5>(z, xVec, yVec, n, getMpzAt);
+		mulVecGLVsmall<GLV, G, 5>(z, xVec, yVec, n, getUnitAt);
 		return true;
 	}
 	if (n >= 128) {
-		return mulVecGLVlarge<GLV, G>(z, xVec, yVec, n, getMpzAt);
+		return mulVecGLVstream<GLV, G>(z, xVec, yVec, n, getUnitAt, isNormalized);
 	}
 	return false;
 }
 
+#ifdef MCL_USE_STD_THREAD
+namespace local {
+
+/*
+	win = sum of the buckets of the w-th window of normalized xVec[0..n)
+	carry[i] is the carry of the w-th window of yVec[i] (it is overwritten)
+	tbl[2^(c-1)] and busy[2^(c-1)] are the work area
+*/
+template<class G>
+void mulVecWindow(G& win, G *tbl, uint8_t *busy, uint8_t *carry, const G *xVec, const Unit *yVec, size_t yUnitSize, size_t next, size_t n, size_t c, size_t w)
+{
+	const size_t tblN = size_t(1) << (c - 1);
+	for (size_t i = 0; i < tblN; i++) {
+		tbl[i].clear();
+	}
+	if (n >= MCL_MIN_N_TO_USE_BATCH_AFFINE) {
+		memset(busy, 0, tblN);
+		BatchAffineBucket<G> bucket(tbl, busy);
+		addWindowToBucket(bucket, carry, xVec, yVec, yUnitSize, next, n, c, w);
+	} else {
+		JacobiBucket<G> bucket(tbl);
+		addWindowToBucket(bucket, carry, xVec, yVec, yUnitSize, next, n, c, w);
+	}
+	G sum;
+	sum.clear();
+	win.clear();
+	for (size_t i = 0; i < tblN; i++) {
+		sum += tbl[tblN - 1 - i];
+		win += sum;
+	}
+}
+
+} // mcl::ec::local
+
+/*
+	estimate #ADD of mulVecMT with cpuN threads
+	point-split : each thread computes mulVec (with GLV) of n / cpuN points
+	window-split : (window, point block) tiles of one mulVec with blockN blocks
+	return true and set c and blockN if window-split is estimated to be faster
+	point-split is used if n / cpuN < 128 because mulVec uses not Pippenger but GLV for such n
+*/
+inline bool estimateMulVecWindowMT(size_t *pc, size_t *pBlockN, size_t n, size_t bitSize, size_t cpuN)
+{
+	if (cpuN <= 1) return false;
+	const size_t m = (n + cpuN - 1) / cpuN;
+	if (m < 128) return false;
+	size_t c = argminForMulVec(m * 2);
+	size_t bestCost = (bitSize / 2 / c + 1) * (m * 2 + (size_t(1) << c));
+	bool found = false;
+	for (size_t blockN = 1; blockN <= cpuN; blockN++) {
+		const size_t mB = (n + blockN - 1) / blockN;
+		c = argminForMulVec(mB);
+		const size_t taskN = (bitSize / c + 1) * blockN;
+		const size_t cost = (taskN + cpuN - 1) / cpuN * (mB + (size_t(1) << c));
+		if (cost < bestCost) {
+			bestCost = cost;
+			*pc = c;
+			*pBlockN = blockN;
+			found = true;
+		}
+	}
+	return found;
+}
+
+/*
+	window-parallel mulVec
+	z = sum_{i=0}^{n-1} xVec[i] * yVec[i] by splitting one Pippenger mulVec with window size c
+	into (window, point block) tiles run in pool
+	c and blockN are estimated if c = 0 and return false if point-split is estimated to be faster
+	return false if malloc fails
+	xVec must be normalized
+*/
+template<class G, class F>
+bool mulVecWindowMT(G& z, const G *xVec, const F *yVec, size_t n, ThreadPool& pool, size_t cpuN = 0, size_t c = 0, size_t blockN = 1)
+{
+	if (cpuN == 0) cpuN = pool.getThreadNum();
+	const size_t bitSize = F::getOp().bitSize;
+	if (c == 0 && !estimateMulVecWindowMT(&c, &blockN, n, bitSize, cpuN)) return false;
+	if (n == 0 || c == 0 || c > 16 || blockN == 0) return false;
+	if (blockN > n) blockN = n;
+	const size_t next = F::getUnitSize();
+	const size_t winN = bitSize / c + 1;
+	const size_t taskN = winN * blockN;
+	// carry[w * n + i] is the carry of the w-th window of yVec[i]
+	G *part = (G*)malloc(sizeof(G) * taskN + sizeof(Unit) * next * n + winN * n);
+	if (part == 0) return false;
+	Unit *yp = (Unit*)(part + taskN);
+	uint8_t *carry = (uint8_t*)(yp + next * n);
+	// convert yVec and compute the carries of all the windows once in parallel
+	const size_t q = n / cpuN;
+	const size_t r = n % cpuN;
+	pool.run(fp::min_(cpuN, n), [&](size_t i) {
+		const size_t adj = q * i + fp::min_(i, r);
+		const size_t num = q + (i < r);
+		const Unit mask = (Unit(1) << c) - 1;
+		const Unit half = Unit(1) << (c - 1);
+		for (size_t j = adj; j < adj + num; j++) {
+			Unit *y = yp + next * j;
+			yVec[j].getUnitArray(y);
+			carry[j] = 0;
+			for (size_t w = 1; w < winN; w++) {
+				carry[w * n + j] = (fp::getUnitAt(y, next, c * (w - 1)) & mask) + carry[(w - 1) * n + j] > half;
+			}
+		}
+	});
+	/*
+		each worker allocates the buckets once and takes the tasks in order
+		a worker failing malloc takes no task, so the others do all of them
+	*/
+	std::atomic<size_t> pos(0), doneN(0);
+	const size_t bq = n / blockN;
+	const size_t br = n % blockN;
+	const size_t tblN = size_t(1) << (c - 1);
+	pool.run(fp::min_(cpuN, taskN), [&](size_t) {
+		G *tbl = (G*)malloc(sizeof(G) * tblN + tblN);
+		if (tbl == 0) return;
+		uint8_t *busy = (uint8_t*)(tbl + tblN);
+		for (;;) {
+			const size_t i = pos++;
+			if (i >= taskN) break;
+			const size_t w = i / blockN;
+			const size_t b = i % blockN;
+			const size_t adj = bq * b + fp::min_(b, br);
+			local::mulVecWindow(part[i], tbl, busy, carry + w * n + adj, xVec + adj, yp + next * adj, next, next, bq + (b < br), c, w);
+			doneN++;
+		}
+		free(tbl);
+	});
+	const bool ok = doneN == taskN;
+	if (ok) {
+		z.clear();
+		for (size_t w = 0; w < winN; w++) {
+			for (size_t i = 0; i < c; i++) {
+				G::dbl(z, z);
+			}
+			const G *p = part + (winN - 1 - w) * blockN;
+			for (size_t b = 0; b < blockN; b++) {
+				z += p[b];
+			}
+		}
+	}
+	free(part);
+	return ok;
+}
+#endif
+
+template<class G> class MulVecTable;
+
 } // mcl::ec
 
 /*
@@ -1166,7 +1846,7 @@ public:
 	*/
 	static bool verifyOrder_;
 	static mpz_class order_;
-	static bool (*mulVecGLV)(EcT& z, const EcT *xVec, const void *yVec, size_t n, fp::getMpzAtType getMpzAt, fp::getUnitAtType getUnitAt, bool constTime);
+	static bool (*mulVecGLV)(EcT& z, const EcT *xVec, const void *yVec, size_t n, fp::getMpzAtType getMpzAt, fp::getUnitAtType getUnitAt, bool constTime, bool isNormalized);
 	static bool (*isValidOrderFast)(const EcT& x);
 	/* default constructor is undefined value */
 	EcT() {}
@@ -1248,7 +1928,7 @@ public:
 	{
 		isValidOrderFast = f;
 	}
-	static void setMulVecGLV(bool f(EcT& z, const EcT *xVec, const void *yVec, size_t yn, fp::getMpzAtType getMpzAt, fp::getUnitAtType getUnitAt, bool constTime))
+	static void setMulVecGLV(bool f(EcT& z, const EcT *xVec, const void *yVec, size_t yn, fp::getMpzAtType getMpzAt, fp::getUnitAtType getUnitAt, bool constTime, bool isNormalized))
 	{
 		mulVecGLV = f;
 	}
@@ -1357,7 +2037,7 @@ public:
 		fp::getMpzAtType getMpzAt = fp::getMpzAtT<F>;
 		fp::getUnitAtType getUnitAt = fp::getUnitAtT<F>;
 		if (mulVecGLV) {
-			mulVecGLV(z, &x, &y, 1, getMpzAt, getUnitAt, constTime);
+			mulVecGLV(z, &x, &y, 1, getMpzAt, getUnitAt, constTime, false);
 			return;
 		}
 		fp::Block b;
@@ -1869,7 +2549,77 @@ private:
 		}
 		return n;
 	}
-
+	/*
+		xVec may be normalized in place through work (= xVec or 0)
+	*/
+	template<class tag, size_t maxBitSize, template<class _tag, size_t _maxBitSize>class FpT>
+	static inline void mulVecMTsub(EcT& z, const EcT *xVec, EcT *work, const FpT<tag, maxBitSize> *yVec, size_t n, size_t cpuN, bool isNormalized)
+	{
+#if defined(MCL_USE_STD_THREAD)
+	ThreadPool& pool = getThreadPool();
+	const size_t taskN = pool.getTaskNum(n, mcl::fp::maxMulVecN, cpuN);
+	if (taskN <= 1) {
+		mulVec(z, xVec, yVec, n, isNormalized);
+		return;
+	}
+	size_t c, blockN;
+	if (ec::estimateMulVecWindowMT(&c, &blockN, n, FpT<tag, maxBitSize>::getOp().bitSize, taskN)) {
+		if (!isNormalized && work) {
+			// normalize xVec in parallel
+			const size_t q = n / taskN;
+			const size_t r = n % taskN;
+			pool.run(taskN, [&](size_t i) {
+				size_t adj = q * i + fp::min_(i, r);
+				normalizeVec(work + adj, work + adj, q + (i < r));
+			});
+			isNormalized = true;
+		}
+		if (isNormalized && ec::mulVecWindowMT(z, xVec, yVec, n, pool, taskN, c, blockN)) return;
+	}
+	EcT *zs = (EcT*)CYBOZU_ALLOCA(sizeof(EcT) * taskN);
+	const size_t q = n / taskN;
+	const size_t r = n % taskN;
+	pool.run(taskN, [&](size_t i) {
+		size_t adj = q * i + fp::min_(i, r);
+		mulVec(zs[i], xVec + adj, yVec + adj, q + (i < r), isNormalized);
+	});
+	z = zs[0];
+	for (size_t i = 1; i < taskN; i++) {
+		z += zs[i];
+	}
+#elif defined(MCL_USE_OMP)
+	(void)work;
+	const size_t minN = mcl::fp::maxMulVecN;
+	if (cpuN == 0) {
+		cpuN = omp_get_num_procs();
+		if (n < minN * cpuN) {
+			cpuN = (n + minN - 1) / minN;
+		}
+	}
+	if (cpuN <= 1 || n <= cpuN) {
+		mulVec(z, xVec, yVec, n, isNormalized);
+		return;
+	}
+	EcT *zs = (EcT*)CYBOZU_ALLOCA(sizeof(EcT) * cpuN);
+	size_t q = n / cpuN;
+	size_t r = n % cpuN;
+	#pragma omp parallel for
+	for (size_t i = 0; i < cpuN; i++) {
+		size_t adj = q * i + fp::min_(i, r);
+		mulVec(zs[i], xVec + adj, yVec + adj, q + (i < r), isNormalized);
+	}
+	z.clear();
+//	#pragma omp declare reduction(red:EcT:omp_out *= omp_in) initializer(omp_priv = omp_orig)
+//	#pragma omp parallel for reduction(red:z)
+	for (size_t i = 0; i < cpuN; i++) {
+		z += zs[i];
+	}
+#else
+		(void)cpuN;
+		(void)work;
+		mulVec(z, xVec, yVec, n, isNormalized);
+#endif
+	}
 public:
 	/*
 		estimation for n multVec
@@ -1889,6 +2639,16 @@ public:
 	*/
 	template<class tag, size_t maxBitSize, template<class _tag, size_t _maxBitSize>class FpT>
 	static inline void mulVec(EcT& z, EcT *xVec, const FpT<tag, maxBitSize> *yVec, size_t n)
+	{
+		mulVec(z, static_cast<const EcT*>(xVec), yVec, n, false);
+	}
+	/*
+		const-input version of mulVec (xVec is not changed)
+		the caller promises that all xVec[i] are normalized (z = 1 or zero) if isNormalized is true
+		and then normalizeVec of xVec is skipped
+	*/
+	template<class tag, size_t maxBitSize, template<class _tag, size_t _maxBitSize>class FpT>
+	static inline void mulVec(EcT& z, const EcT *xVec, const FpT<tag, maxBitSize> *yVec, size_t n, bool isNormalized)
 	{
 		typedef FpT<tag, maxBitSize> F;
 		fp::getMpzAtType getMpzAt = fp::getMpzAtT<F>;
@@ -1897,7 +2657,7 @@ public:
 			z.clear();
 			return;
 		}
-		if (mulVecGLV && mulVecGLV(z, xVec, yVec, n, getMpzAt, getUnitAt, false)) {
+		if (mulVecGLV && mulVecGLV(z, xVec, yVec, n, getMpzAt, getUnitAt, false, isNormalized)) {
 			return;
 		}
 		EcT r;
@@ -1914,39 +2674,27 @@ public:
 	}
 	// multi thread version of mulVec
 	// the num of thread is automatically detected if cpuN = 0
+	// use getThreadPool() if MCL_USE_STD_THREAD is defined
+	// and split the windows (ec::mulVecWindowMT) or the points automatically
 	template<class tag, size_t maxBitSize, template<class _tag, size_t _maxBitSize>class FpT>
 	static inline void mulVecMT(EcT& z, EcT *xVec, const FpT<tag, maxBitSize> *yVec, size_t n, size_t cpuN = 0)
 	{
-#ifdef MCL_USE_OMP
-	const size_t minN = mcl::fp::maxMulVecN;
-	if (cpuN == 0) {
-		cpuN = omp_get_num_procs();
-		if (n < minN * cpuN) {
-			cpuN = (n + minN - 1) / minN;
-		}
-	}
-	if (cpuN <= 1 || n <= cpuN) {
-		mulVec(z, xVec, yVec, n);
-		return;
-	}
-	EcT *zs = (EcT*)CYBOZU_ALLOCA(sizeof(EcT) * cpuN);
-	size_t q = n / cpuN;
-	size_t r = n % cpuN;
-	#pragma omp parallel for
-	for (size_t i = 0; i < cpuN; i++) {
-		size_t adj = q * i + fp::min_(i, r);
-		mulVec(zs[i], xVec + adj, yVec + adj, q + (i < r));
+		mulVecMTsub(z, xVec, xVec, yVec, n, cpuN, false);
 	}
-	z.clear();
-//	#pragma omp declare reduction(red:EcT:omp_out *= omp_in) initializer(omp_priv = omp_orig)
-//	#pragma omp parallel for reduction(red:z)
-	for (size_t i = 0; i < cpuN; i++) {
-		z += zs[i];
+	// const-input version of mulVecMT (see mulVec)
+	template<class tag, size_t maxBitSize, template<class _tag, size_t _maxBitSize>class FpT>
+	static inline void mulVecMT(EcT& z, const EcT *xVec, const FpT<tag, maxBitSize> *yVec, size_t n, size_t cpuN, bool isNormalized)
+	{
+		mulVecMTsub(z, xVec, 0, yVec, n, cpuN, isNormalized);
 	}
-#else
-		(void)cpuN;
-		mulVec(z, xVec, yVec, n);
-#endif
+	/*
+		mulVec for the fixed bases with the precomputed table
+		see ec::MulVecTable
+	*/
+	template<class tag, size_t maxBitSize, template<class _tag, size_t _maxBitSize>class FpT>
+	static inline void mulVecPrecomputed(bool *pb, EcT& z, const ec::MulVecTable<EcT>& tbl, const FpT<tag, maxBitSize> *yVec, size_t n)
+	{
+		tbl.mulVec(pb, z, yVec, n);
 	}
 #ifndef CYBOZU_DONT_USE_EXCEPTION
 	static inline void init(const std::string& astr, const std::string& bstr, int mode = ec::Jacobi)
@@ -1975,6 +2723,11 @@ public:
 		load(&b, is, ioMode);
 		if (!b) throw cybozu::Exception("EcT:load");
 	}
+	template<class tag, size_t maxBitSize, template<class _tag, size_t _maxBitSize>class FpT>
+	static inline void mulVecPrecomputed(EcT& z, const ec::MulVecTable<EcT>& tbl, const FpT<tag, maxBitSize> *yVec, size_t n)
+	{
+		tbl.mulVec(z, yVec, n);
+	}
 #endif
 #ifndef CYBOZU_DONT_USE_STRING
 	// backward compatilibity
@@ -2001,10 +2754,512 @@ template<class Fp> int EcT<Fp>::specialA_;
 template<class Fp> int EcT<Fp>::ioMode_;
 template<class Fp> bool EcT<Fp>::verifyOrder_;
 template<class Fp> mpz_class EcT<Fp>::order_;
-template<class Fp> bool (*EcT<Fp>::mulVecGLV)(EcT& z, const EcT *xVec, const void *yVec, size_t n, fp::getMpzAtType getMpzAt, fp::getUnitAtType getUnitAt, bool constTime);
+template<class Fp> bool (*EcT<Fp>::mulVecGLV)(EcT& z, const EcT *xVec, const void *yVec, size_t n, fp::getMpzAtType getMpzAt, fp::getUnitAtType getUnitAt, bool constTime, bool isNormalized);
 template<class Fp> bool (*EcT<Fp>::isValidOrderFast)(const EcT& x);
 template<class Fp> int EcT<Fp>::mode_;
 
+namespace ec { namespace local {
+
+template<class Fp>
+struct CanUseBatchAffine<EcT<Fp> > {
+	static const bool value = true;
+};
+
+} } // mcl::ec::local
+
+namespace ec {
+
+namespace local {
+
+inline void saveUint32(bool *pb, uint8_t *buf, size_t pos, size_t v)
+{
+	*pb = v <= 0xffffffff;
+	for (int i = 0; i < 4; i++) {
+		buf[pos + i] = uint8_t(v >> (i * 8));
+	}
+}
+
+inline size_t loadUint32(const uint8_t *buf, size_t pos)
+{
+	uint32_t v = 0;
+	for (int i = 0; i < 4; i++) {
+		v |= uint32_t(buf[pos + i]) << (i * 8);
+	}
+	return v;
+}
+
+} // mcl::ec::local
+
+/*
+	mulVec for the fixed bases with the precomputed table
+	z = sum_{i=0}^{n-1} xVec[i] * yVec[i] for n <= size() and any yVec
+	each yVec[i] is recoded to winN = bitSize / c + 1 signed c-bit digits d_w (see mulVecCore)
+	tbl_[i * rowN + j] = 2^(c step j) xVec[i] (normalized)
+	the digit d_w (w = j step + r) adds tbl_[i * rowN + j] to the r-th bucket set
+	and z = sum_{r=0}^{step-1} 2^(c r) (sum of the r-th buckets)
+	step is the trade-off between the memory and the speed
+	step = 1 : n * winN points in tbl_ and no doubling in mulVec (fastest)
+	step = k : about 1/k points of step = 1 and c * (k - 1) doublings in mulVec
+*/
+template<class G>
+class MulVecTable {
+	size_t n_;
+	size_t bitSize_;
+	size_t c_;
+	size_t step_;
+	size_t winN_;
+	size_t rowN_;
+	mcl::Array<G> tbl_;
+	static const size_t headerSize = 16;
+	struct Param {
+		size_t n;
+		size_t bitSize;
+		size_t c;
+		size_t step;
+		size_t winN;
+		size_t rowN;
+	};
+	static bool getParam(Param& p, size_t n, size_t bitSize, size_t c, size_t step)
+	{
+		if (n == 0 || bitSize == 0 || c == 0 || c > maxC || step == 0) return false;
+		p.n = n;
+		p.bitSize = bitSize;
+		p.c = c;
+		p.winN = bitSize / c + 1;
+		p.step = fp::min_(step, p.winN);
+		p.rowN = (p.winN + p.step - 1) / p.step;
+		return true;
+	}
+	// the members are updated only if the table is completely made
+	void set(const Param& p, mcl::Array<G>& tbl)
+	{
+		n_ = p.n;
+		bitSize_ = p.bitSize;
+		c_ = p.c;
+		step_ = p.step;
+		winN_ = p.winN;
+		rowN_ = p.rowN;
+		tbl_.swap(tbl);
+	}
+	template<class Bucket>
+	void addToBucket(Bucket& bucket, const void *yVec, size_t n, size_t yUnitSize, fp::getUnitAtType getUnitAt) const
+	{
+		const size_t tblN = size_t(1) << (c_ - 1);
+		const Unit mask = (Unit(1) << c_) - 1;
+		const Unit half = Unit(1) << (c_ - 1);
+		Unit *y = (Unit*)CYBOZU_ALLOCA(sizeof(Unit) * yUnitSize);
+		for (size_t i = 0; i < n; i++) {
+			getUnitAt(y, yVec, i);
+			const G *row = &tbl_[i * rowN_];
+			Unit carry = 0;
+			for (size_t w = 0; w < winN_; w++) {
+				Unit v = (fp::getUnitAt(y, yUnitSize, c_ * w) & mask) + carry;
+				const bool negP = v > half;
+				if (negP) {
+					carry = 1;
+					v = mask + 1 - v;
+				} else {
+					carry = 0;
+				}
+				if (v == 0) continue;
+				bucket.add((w % step_) * tblN + v - 1, row[w / step_], negP);
+			}
+		}
+		bucket.finish();
+	}
+public:
+	static const size_t maxC = 16;
+	MulVecTable()
+		: n_(0)
+		, bitSize_(0)
+		, c_(0)
+		, step_(0)
+		, winN_(0)
+		, rowN_(0)
+	{
+	}
+	size_t size() const { return n_; }
+	size_t getBitSize() const { return bitSize_; }
+	size_t getWindowSize() const { return c_; }
+	size_t getStep() const { return step_; }
+	// num of the precomputed points
+	size_t getTableSize() const { return tbl_.size(); }
+	/*
+		return c minimizing #ADD = n * winN + step * 2^c
+	*/
+	static size_t estimateWindowSize(size_t n, size_t bitSize, size_t step = 1)
+	{
+		size_t bestC = 1;
+		size_t bestCost = size_t(-1);
+		for (size_t c = 1; c <= maxC; c++) {
+			size_t cost = n * (bitSize / c + 1) + (step << c);
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestC = c;
+			}
+		}
+		return bestC;
+	}
+	/*
+		@param xVec [in] fixed bases
+		@param n [in] num of xVec
+		@param bitSize [in] max bit size of scalars (e.g. Fr::getBitSize())
+		@param step [in] 1 is the fastest and uses the largest table
+		@param c [in] window size (auto if c = 0)
+	*/
+	void init(bool *pb, const G *xVec, size_t n, size_t bitSize, size_t step = 1, size_t c = 0)
+	{
+		if (c == 0) c = estimateWindowSize(n, bitSize, step);
+		Param p;
+		*pb = getParam(p, n, bitSize, c, step);
+		if (!*pb) return;
+		mcl::Array<G> tbl;
+		*pb = tbl.resize(n * p.rowN);
+		if (!*pb) return;
+		const size_t shift = p.c * p.step;
+		for (size_t i = 0; i < n; i++) {
+			G *row = &tbl[i * p.rowN];
+			G t = xVec[i];
+			for (size_t j = 0; j < p.rowN; j++) {
+				row[j] = t;
+				if (j + 1 == p.rowN) break;
+				for (size_t k = 0; k < shift; k++) {
+					G::dbl(t, t);
+				}
+			}
+		}
+		G::normalizeVec(tbl.data(), tbl.data(), tbl.size());
+		set(p, tbl);
+	}
+	/*
+		z = sum_{i=0}^{n-1} xVec[i] * yVec[i] where xVec is given in init
+		*pb = false if n > size(), the bit size of F is larger than getBitSize() or malloc fails
+	*/
+	template<class F>
+	void mulVec(bool *pb, G& z, const F *yVec, size_t n) const
+	{
+		if (n > n_ || F::getOp().bitSize > bitSize_) {
+			*pb = false;
+			return;
+		}
+		if (n == 0) {
+			z.clear();
+			*pb = true;
+			return;
+		}
+		const size_t tblN = size_t(1) << (c_ - 1);
+		const size_t bucketN = tblN * step_;
+		G *tbl = (G*)malloc(sizeof(G) * bucketN + bucketN);
+		if (tbl == 0) {
+			*pb = false;
+			return;
+		}
+		uint8_t *busy = (uint8_t*)(tbl + bucketN);
+		for (size_t i = 0; i < bucketN; i++) {
+			tbl[i].clear();
+		}
+		memset(busy, 0, bucketN);
+		if (n * winN_ >= MCL_MIN_N_TO_USE_BATCH_AFFINE) {
+			local::BatchAffineBucket<G> bucket(tbl, busy);
+			addToBucket(bucket, yVec, n, F::getUnitSize(), fp::getUnitAtT<F>);
+		} else {
+			local::JacobiBucket<G> bucket(tbl);
+			addToBucket(bucket, yVec, n, F::getUnitSize(), fp::getUnitAtT<F>);
+		}
+		z.clear();
+		for (size_t r = 0; r < step_; r++) {
+			for (size_t i = 0; i < c_; i++) {
+				G::dbl(z, z);
+			}
+			const G *B = tbl + (step_ - 1 - r) * tblN;
+			G sum, win;
+			sum.clear();
+			win.clear();
+			for (size_t i = 0; i < tblN; i++) {
+				sum += B[tblN - 1 - i];
+				win += sum;
+			}
+			z += win;
+		}
+		free(tbl);
+		*pb = true;
+	}
+	/*
+		header (n, bitSize, c, step as uint32_t little endian) and the points of tbl_ by IoEcAffineSerialize
+	*/
+	template<class OutputStream>
+	void save(bool *pb, OutputStream& os) const
+	{
+		uint8_t buf[headerSize];
+		const size_t v[] = { n_, bitSize_, c_, step_ };
+		for (size_t i = 0; i < 4; i++) {
+			local::saveUint32(pb, buf, i * 4, v[i]);
+			if (!*pb) return;
+		}
+		cybozu::write(pb, os, buf, headerSize);
+		if (!*pb) return;
+		for (size_t i = 0; i < tbl_.size(); i++) {
+			tbl_[i].save(pb, os, IoEcAffineSerialize);
+			if (!*pb) return;
+		}
+	}
+	/*
+		each point is verified by G::load (and its order is also checked if verifyOrder is true)
+		*this is not changed if it fails
+	*/
+	template<class InputStream>
+	void load(bool *pb, InputStream& is)
+	{
+		uint8_t buf[headerSize];
+		cybozu::read(pb, buf, headerSize, is);
+		if (!*pb) return;
+		size_t v[4];
+		for (size_t i = 0; i < 4; i++) {
+			v[i] = local::loadUint32(buf, i * 4);
+		}
+		Param p;
+		*pb = getParam(p, v[0], v[1], v[2], v[3]) && p.step == v[3];
+		if (!*pb) return;
+		mcl::Array<G> tbl;
+		*pb = tbl.resize(p.n * p.rowN);
+		if (!*pb) return;
+		for (size_t i = 0; i < tbl.size(); i++) {
+			tbl[i].load(pb, is, IoEcAffineSerialize);
+			if (!*pb) return;
+		}
+		set(p, tbl);
+	}
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+	void init(const G *xVec, size_t n, size_t bitSize, size_t step = 1, size_t c = 0)
+	{
+		bool b;
+		init(&b, xVec, n, bitSize, step, c);
+		if (!b) throw cybozu::Exception("mcl:MulVecTable:init") << n << bitSize << step << c;
+	}
+	template<class F>
+	void mulVec(G& z, const F *yVec, size_t n) const
+	{
+		bool b;
+		mulVec(&b, z, yVec, n);
+		if (!b) throw cybozu::Exception("mcl:MulVecTable:mulVec") << n << n_;
+	}
+	template<class OutputStream>
+	void save(OutputStream& os) const
+	{
+		bool b;
+		save(&b, os);
+		if (!b) throw cybozu::Exception("mcl:MulVecTable:save");
+	}
+	template<class InputStream>
+	void load(InputStream& is)
+	{
+		bool b;
+		load(&b, is);
+		if (!b) throw cybozu::Exception("mcl:MulVecTable:load");
+	}
+#endif
+};
+
+/*
+	a reader of mulVecStream for arrays (e.g. memory-mapped files)
+*/
+template<class G, class F>
+class MulVecArrayReader {
+	const G *xVec_;
+	const F *yVec_;
+	size_t n_;
+	size_t pos_;
+public:
+	MulVecArrayReader(const G *xVec, const F *yVec, size_t n)
+		: xVec_(xVec)
+		, yVec_(yVec)
+		, n_(n)
+		, pos_(0)
+	{
+	}
+	size_t read(G *xVec, F *yVec, size_t maxN)
+	{
+		const size_t n = fp::min_(maxN, n_ - pos_);
+		for (size_t i = 0; i < n; i++) {
+			xVec[i] = xVec_[pos_ + i];
+			yVec[i] = yVec_[pos_ + i];
+		}
+		pos_ += n;
+		return n;
+	}
+};
+
+/*
+	streaming mulVec for xVec and yVec which do not fit in memory
+	z = sum_i xVec[i] * yVec[i]
+	reader.read(G *x, F *y, size_t maxN) sets at most maxN pairs to x[] and y[]
+	and returns the num of them (0 means the end)
+	each chunk of chunkN pairs is added to the buckets of all windows,
+	so only the buckets and one chunk are kept in memory
+	@param n [in] estimated total num of pairs to choose c
+	@param chunkN [in] max num of pairs in a chunk
+	@param c [in] window size (auto if c = 0)
+	return false if malloc fails or reader returns more than chunkN
+	G must be EcT
+*/
+template<class G, class F, class Reader>
+bool mulVecStream(G& z, Reader& reader, size_t n, size_t chunkN = 4096, size_t c = 0)
+{
+	if (chunkN == 0) return false;
+	if (c == 0) {
+		c = fp::min_<size_t>(argminForMulVec(n), MCL_MAX_C_FOR_MUL_VEC_STREAM);
+	}
+	const bool useBatchAffine = n >= MCL_MIN_N_TO_USE_BATCH_AFFINE;
+	const size_t next = F::getUnitSize();
+	const size_t winN = F::getOp().bitSize / c + 1;
+	const size_t bucketSize = local::WindowBuckets<G>::getBufSize(c, winN, chunkN);
+	G *x = (G*)malloc(bucketSize + (sizeof(G) + sizeof(F) + sizeof(Unit) * next) * chunkN);
+	if (x == 0) return false;
+	F *y = (F*)(x + chunkN);
+	Unit *yp = (Unit*)(y + chunkN);
+	local::WindowBuckets<G> buckets;
+	buckets.init(yp + next * chunkN, c, winN, useBatchAffine);
+	bool ok = true;
+	for (;;) {
+		const size_t m = reader.read(x, y, chunkN);
+		if (m == 0) break;
+		if (m > chunkN) {
+			ok = false;
+			break;
+		}
+		if (useBatchAffine) G::normalizeVec(x, x, m);
+		for (size_t i = 0; i < m; i++) {
+			y[i].getUnitArray(yp + next * i);
+		}
+		buckets.add(x, yp, next, next, m);
+	}
+	if (ok) buckets.get(z);
+	free(x);
+	return ok;
+}
+
+namespace local {
+
+// split x by GLV::split(mpz_class u[], mpz_class& x)
+template<class GLV>
+void splitByMpz(Unit *u, size_t stride, bool neg[], const Unit *x)
+{
+	const size_t n = GLV::Fr::getUnitSize();
+	mpz_class mu[GLV::splitN], mx;
+	bool b;
+	gmp::setArray(&b, mx, x, n);
+	assert(b); (void)b;
+	GLV::split(mu, mx);
+	for (int i = 0; i < GLV::splitN; i++) {
+		neg[i] = mu[i] < 0;
+		if (neg[i]) gmp::neg(mu[i], mu[i]);
+		gmp::getArray(&b, u + stride * i, n, mu[i]);
+		assert(b); (void)b;
+	}
+}
+
+/*
+	fixed-width lattice decomposition by Babai rounding without mpz_class
+	t[j] = (x * v[j]) >> rBitSize
+	u[i] = (i == 0 ? x : 0) - sum_j t[j] B[j][i]
+	x has n units and |u[i]| < 2^(UnitBitSize * n)
+*/
+template<int splitN, size_t maxN>
+class UnitSplitter {
+	size_t n_;
+	size_t shiftN_; // rBitSize / UnitBitSize
+	Unit v_[splitN][maxN + 1];
+	size_t vn_[splitN];
+	bool vNeg_[splitN];
+	Unit B_[splitN][splitN][maxN];
+	size_t bn_[splitN][splitN];
+	bool bNeg_[splitN][splitN];
+	bool isValid_;
+	static bool set(Unit *y, size_t *pn, bool *pNeg, size_t maxSize, const mpz_class& x)
+	{
+		mpz_class t = x;
+		*pNeg = t < 0;
+		if (*pNeg) gmp::neg(t, t);
+		bool b;
+		gmp::getArray(&b, y, maxSize, t);
+		if (!b) return false;
+		*pn = bint::getRealSize(y, maxSize);
+		return true;
+	}
+public:
+	UnitSplitter() : isValid_(false) {}
+	bool isValid() const { return isValid_; }
+	void init(size_t n, size_t rBitSize, const mpz_class *v, const mpz_class (*B)[splitN])
+	{
+		isValid_ = false;
+		if (n > maxN || (rBitSize % UnitBitSize) != 0) return;
+		n_ = n;
+		shiftN_ = rBitSize / UnitBitSize;
+		for (int j = 0; j < splitN; j++) {
+			if (!set(v_[j], &vn_[j], &vNeg_[j], maxN + 1, v[j])) return;
+			if (vn_[j] > shiftN_ + 1) return;
+			for (int i = 0; i < splitN; i++) {
+				if (!set(B_[j][i], &bn_[j][i], &bNeg_[j][i], maxN, B[j][i])) return;
+			}
+		}
+		isValid_ = true;
+	}
+	/*
+		x[n] < r
+		u + stride * i = |u[i]| (n units), neg[i] = u[i] < 0
+	*/
+	void split(Unit *u, size_t stride, bool neg[splitN], const Unit *x) const
+	{
+		assert(isValid_);
+		const size_t n = n_;
+		const size_t m = n + 1; // acc is m units two's complement
+		Unit t[splitN][maxN + 2];
+		size_t tn[splitN];
+		Unit prod[maxN * 2 + 2];
+		for (int j = 0; j < splitN; j++) {
+			tn[j] = 0;
+			if (vn_[j] == 0) continue;
+			bint::mulNM(prod, x, n, v_[j], vn_[j]);
+			const size_t pn = n + vn_[j];
+			if (pn <= shiftN_) continue;
+			tn[j] = bint::getRealSize(prod + shiftN_, pn - shiftN_);
+			bint::copyN(t[j], prod + shiftN_, tn[j]);
+		}
+		for (int i = 0; i < splitN; i++) {
+			Unit acc[maxN + 1];
+			if (i == 0) {
+				bint::copyN(acc, x, n);
+			} else {
+				bint::clearN(acc, n);
+			}
+			acc[n] = 0;
+			for (int j = 0; j < splitN; j++) {
+				const size_t bn = bn_[j][i];
+				if (tn[j] == 0 || bn == 0) continue;
+				bint::mulNM(prod, t[j], tn[j], B_[j][i], bn);
+				const size_t pn = tn[j] + bn;
+				if (pn < m) bint::clearN(prod + pn, m - pn);
+				if (vNeg_[j] ^ bNeg_[j][i]) {
+					bint::addN(acc, acc, prod, m);
+				} else {
+					bint::subN(acc, acc, prod, m);
+				}
+			}
+			neg[i] = (acc[n] >> (UnitBitSize - 1)) != 0;
+			if (neg[i]) {
+				for (size_t k = 0; k < m; k++) acc[k] = ~acc[k];
+				bint::addUnit(acc, m, 1);
+			}
+			assert(acc[n] == 0);
+			bint::copyN(u + stride * i, acc, n);
+		}
+	}
+};
+
+} // mcl::ec::local
+
+} // mcl::ec
+
 // r = the order of Ec
 template<class Ec, class _Fr>
 struct GLV1T {
@@ -2016,6 +3271,7 @@ struct GLV1T {
 	static size_t rBitSize;
 	static mpz_class v0, v1;
 	static mpz_class B[2][2];
+	static ec::local::UnitSplitter<2, Fr::maxSize> splitter;
 public:
 #ifndef CYBOZU_DONT_USE_STRING
 	static void dump(const mpz_class& x)
@@ -2054,6 +3310,25 @@ public:
 		a = x - (t * B[0][0] + b * B[1][0]);
 		b = - (t * B[0][1] + b * B[1][1]);
 	}
+	/*
+		same as split but without mpz_class
+		x[Fr::getUnitSize()] < r
+		u + stride * i = |u[i]|, neg[i] = u[i] < 0
+	*/
+	static void split(Unit *u, size_t stride, bool neg[2], const Unit *x)
+	{
+		if (splitter.isValid()) {
+			splitter.split(u, stride, neg, x);
+			return;
+		}
+		ec::local::splitByMpz<GLV1>(u, stride, neg, x);
+	}
+	// call this after setting rBitSize, v0, v1, B
+	static void initSplitter()
+	{
+		const mpz_class v[2] = { v0, v1 };
+		splitter.init(Fr::getUnitSize(), rBitSize, v, B);
+	}
 	/*
 		initForBN() is defined in bn.hpp
 	*/
@@ -2075,6 +3350,7 @@ public:
 		const mpz_class& r = Fr::getOp().mp;
 		v0 = ((B[1][1]) << rBitSize) / r;
 		v1 = ((-B[0][1]) << rBitSize) / r;
+		initSplitter();
 	}
 };
 
@@ -2084,6 +3360,7 @@ template<class Ec, class Fr> size_t GLV1T<Ec, Fr>::rBitSize;
 template<class Ec, class Fr> mpz_class GLV1T<Ec, Fr>::v0;
 template<class Ec, class Fr> mpz_class GLV1T<Ec, Fr>::v1;
 template<class Ec, class Fr> mpz_class GLV1T<Ec, Fr>::B[2][2];
+template<class Ec, class Fr> ec::local::UnitSplitter<2, Fr::maxSize> GLV1T<Ec, Fr>::splitter;
 
 /*
 	Ec : elliptic curve
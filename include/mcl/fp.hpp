@@ -61,6 +61,17 @@ uint32_t sha512(void *out, uint32_t maxOutSize, const void *msg, uint32_t msgSiz
 
 // draft-07 outSize = 128 or 256
 void expand_message_xmd(uint8_t out[], size_t outSize, const void *msg, size_t msgSize, const void *dst, size_t dstSize);
+/*
+	the rest of expand_message_xmd after b0 = SHA-256(Z_pad | msg | BE(outSize, 2) | BE(0, 1) | dst | BE(dstSize, 1))
+	dstSize <= 255 (a larger dst must be hashed before computing b0)
+*/
+void expand_message_xmd_from_b0(uint8_t out[], size_t outSize, const uint8_t b0[32], const void *dst, size_t dstSize);
+/*
+	expand_message_xmd for n messages
+	outVec[outSize * i] = expand_message_xmd(msgVec[i], msgSizeVec[i]) for i = 0, ..., n-1
+	SHA-256 of several messages are computed in parallel by AVX2/AVX-512 if available
+*/
+void expand_message_xmdVec(uint8_t *outVec, size_t outSize, const void *const *msgVec, const size_t *msgSizeVec, size_t n, const void *dst, size_t dstSize);
 
 namespace local {
 
@@ -1291,11 +1291,35 @@ struct Fp12T : public fp::Serializable<Fp12T<Fp>,
 		}
 #endif
 	}
+	/*
+		check the order of the elements in load() if verifyOrder_ is true
+	*/
+	static bool verifyOrder_;
+	static bool (*isValidOrderFast)(const Fp12T& x);
+	static void setVerifyOrder(bool doVerify)
+	{
+		verifyOrder_ = doVerify;
+	}
+	static void setVerifyOrderFunc(bool f(const Fp12T&))
+	{
+		isValidOrderFast = f;
+	}
+	// verify the order (always true if no function is set)
+	bool isValidOrder() const
+	{
+		if (isValidOrderFast) {
+			return isValidOrderFast(*this);
+		}
+		return true;
+	}
 	template<class InputStream>
 	void load(bool *pb, InputStream& is, int ioMode)
 	{
 		a.load(pb, is, ioMode); if (!*pb) return;
-		b.load(pb, is, ioMode);
+		b.load(pb, is, ioMode); if (!*pb) return;
+		if (verifyOrder_ && !isValidOrder()) {
+			*pb = false;
+		}
 	}
 	template<class OutputStream>
 	void save(bool *pb, OutputStream& os, int ioMode) const
@@ -1417,6 +1441,9 @@ private:
 	}
 };
 
+template<class Fp> bool Fp12T<Fp>::verifyOrder_;
+template<class Fp> bool (*Fp12T<Fp>::isValidOrderFast)(const Fp12T& x);
+
 /*
 	convert multiplicative group to additive group
 */
@@ -0,0 +1,223 @@
+#pragma once
+/**
+	@file
+	@brief LRU cache of validated G2 points and their precomputed line coefficients
+	@license modified new BSD license
+	http://opensource.org/licenses/BSD-3-Clause
+	@note C++11 is required
+	include this after mcl/bn256.hpp, mcl/bls12_381.hpp, etc. to set MCL_MAX_FP_BIT_SIZE
+*/
+#include <mcl/bn.hpp>
+#include <mutex>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mcl { namespace bn {
+
+/*
+	map serialized G2 bytes to the point (whose order is always verified) and its Qcoeff of precomputeG2
+	the least recently used entries are removed if the total size exceeds maxByte
+	thread-safe
+	all the entries are removed if the curve is changed by initPairing
+	or the serialization mode is changed by Fp::setETHserialization
+*/
+class G2Cache {
+public:
+	struct Entry {
+		G2 Q;
+		std::vector<Fp6> Qcoeff; // empty if not computed yet
+	};
+	typedef std::shared_ptr<const Entry> EntryPtr;
+private:
+	typedef std::list<std::string> KeyList;
+	struct Value {
+		EntryPtr e;
+		KeyList::iterator pos; // position in lru_
+		size_t byteSize;
+	};
+	typedef std::unordered_map<std::string, Value> Map;
+	mutable std::mutex m_;
+	Map map_;
+	KeyList lru_; // the front is the most recently used
+	size_t maxByte_;
+	size_t byteSize_;
+	uint64_t hitNum_;
+	uint64_t missNum_;
+	int curveType_;
+	bool isETH_;
+	G2Cache(const G2Cache&);
+	void operator=(const G2Cache&);
+	// approximate size of an entry including the nodes of map_ and lru_
+	static size_t getEntryByteSize(const std::string& key, const Entry& e)
+	{
+		return sizeof(Entry) + sizeof(Value) + 2 * (key.size() + sizeof(std::string) + 4 * sizeof(void*)) + e.Qcoeff.size() * sizeof(Fp6);
+	}
+	void clearNoLock()
+	{
+		map_.clear();
+		lru_.clear();
+		byteSize_ = 0;
+	}
+	void shrinkNoLock(size_t maxByte)
+	{
+		while (byteSize_ > maxByte && !lru_.empty()) {
+			Map::iterator i = map_.find(lru_.back());
+			byteSize_ -= i->second.byteSize;
+			map_.erase(i);
+			lru_.pop_back();
+		}
+	}
+	// clear all if the curve or the serialization mode is changed
+	void checkModeNoLock()
+	{
+		if (curveType_ != BN::param.cp.curveType || isETH_ != Fp::isETHserialization()) {
+			clearNoLock();
+			curveType_ = BN::param.cp.curveType;
+			isETH_ = Fp::isETHserialization();
+		}
+	}
+	void insert(const std::string& key, const EntryPtr& e)
+	{
+		const size_t byteSize = getEntryByteSize(key, *e);
+		std::lock_guard<std::mutex> lk(m_);
+		checkModeNoLock();
+		Map::iterator i = map_.find(key);
+		if (i != map_.end()) {
+			byteSize_ -= i->second.byteSize;
+			lru_.erase(i->second.pos);
+			map_.erase(i);
+		}
+		if (byteSize > maxByte_) return;
+		shrinkNoLock(maxByte_ - byteSize);
+		lru_.push_front(key);
+		Value v = { e, lru_.begin(), byteSize };
+		map_.insert(std::make_pair(key, v));
+		byteSize_ += byteSize;
+	}
+public:
+	explicit G2Cache(size_t maxByte = 0)
+		: maxByte_(maxByte)
+		, byteSize_(0)
+		, hitNum_(0)
+		, missNum_(0)
+		, curveType_(-1)
+		, isETH_(false)
+	{
+	}
+	// the cache is disabled if maxByte = 0
+	void setMaxByte(size_t maxByte)
+	{
+		std::lock_guard<std::mutex> lk(m_);
+		maxByte_ = maxByte;
+		shrinkNoLock(maxByte);
+	}
+	size_t getMaxByte() const
+	{
+		std::lock_guard<std::mutex> lk(m_);
+		return maxByte_;
+	}
+	// approximate total size of the entries
+	size_t getByteSize() const
+	{
+		std::lock_guard<std::mutex> lk(m_);
+		return byteSize_;
+	}
+	size_t size() const
+	{
+		std::lock_guard<std::mutex> lk(m_);
+		return map_.size();
+	}
+	uint64_t getHitNum() const
+	{
+		std::lock_guard<std::mutex> lk(m_);
+		return hitNum_;
+	}
+	uint64_t getMissNum() const
+	{
+		std::lock_guard<std::mutex> lk(m_);
+		return missNum_;
+	}
+	void clear()
+	{
+		std::lock_guard<std::mutex> lk(m_);
+		clearNoLock();
+		hitNum_ = 0;
+		missNum_ = 0;
+	}
+	/*
+		return the entry of buf[bufSize] (serialized G2 by G2::serialize)
+		Qcoeff of the entry is set if needQcoeff
+		return null if buf is not a valid G2 point
+		the entry is valid even if it is removed from the cache
+	*/
+	EntryPtr get(const void *buf, size_t bufSize, bool needQcoeff = false)
+	{
+		const std::string key((const char*)buf, bufSize);
+		EntryPtr e;
+		{
+			std::lock_guard<std::mutex> lk(m_);
+			checkModeNoLock();
+			Map::iterator i = map_.find(key);
+			if (i != map_.end()) {
+				e = i->second.e;
+				if (!needQcoeff || !e->Qcoeff.empty()) {
+					lru_.splice(lru_.begin(), lru_, i->second.pos);
+					hitNum_++;
+					return e;
+				}
+			}
+			missNum_++;
+		}
+		// compute without the lock
+		std::shared_ptr<Entry> ne(new Entry());
+		if (e) {
+			ne->Q = e->Q;
+		} else {
+			// deserialize checks the order if verifyOrder_ is true
+			if (ne->Q.deserialize(buf, bufSize) != bufSize) return EntryPtr();
+			if (!G2::verifyOrder_ && !ne->Q.isValidOrder()) return EntryPtr();
+		}
+		if (needQcoeff) {
+			precomputeG2(ne->Qcoeff, ne->Q);
+		}
+		insert(key, ne);
+		return ne;
+	}
+	/*
+		Q = deserialized buf[bufSize] (its order is verified)
+		return bufSize if success else 0
+	*/
+	size_t deserialize(G2& Q, const void *buf, size_t bufSize)
+	{
+		EntryPtr e = get(buf, bufSize);
+		if (!e) return 0;
+		Q = e->Q;
+		return bufSize;
+	}
+	/*
+		f = MillerLoop(P, Q) where Q is deserialized buf[bufSize]
+		return false if buf is not a valid G2 point
+	*/
+	bool millerLoop(Fp12& f, const G1& P, const void *buf, size_t bufSize)
+	{
+		EntryPtr e = get(buf, bufSize, true);
+		if (!e) return false;
+		precomputedMillerLoop(f, P, e->Qcoeff);
+		return true;
+	}
+};
+
+/*
+	the cache used by mclBnG2_deserialize and mclBn_millerLoopCachedG2 of the C API
+	it is disabled until setMaxByte() is called
+*/
+inline G2Cache& getG2Cache()
+{
+	static G2Cache cache;
+	return cache;
+}
+
+} } // mcl::bn
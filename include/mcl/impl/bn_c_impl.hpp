@@ -18,6 +18,11 @@
 #endif
 #include <mcl/lagrange.hpp>
 #include <mcl/ecparam.hpp>
+// the cache of G2 requires C++11 (define MCL_NO_G2_CACHE to disable it)
+#if !defined(MCL_NO_G2_CACHE) && (CYBOZU_CPP_VERSION >= CYBOZU_CPP_VERSION_CPP11)
+	#define MCL_USE_G2_CACHE
+#include <mcl/g2_cache.hpp>
+#endif
 using namespace mcl::bn;
 
 static Fr *cast(mclBnFr *p) { return reinterpret_cast<Fr*>(p); }
@@ -48,6 +53,18 @@ int setStr(T *x, const char *buf, mclSize bufSize, int ioMode)
 	return n > 0 ? 0 : -1;
 }
 
+// reader of mcl::ec::mulVecStream for the callback of mclBnG{1,2}_mulVecStream
+template<class T>
+struct CallbackReader {
+	mclSize (*f)(T *x, mclBnFr *y, mclSize maxN, void *self);
+	void *self;
+	template<class G>
+	size_t read(G *x, Fr *y, size_t maxN)
+	{
+		return f(reinterpret_cast<T*>(x), reinterpret_cast<mclBnFr*>(y), maxN, self);
+	}
+};
+
 #ifdef __EMSCRIPTEN__
 // use these functions forcibly
 extern "C" MCLBN_DLL_API void *mclBnMalloc(size_t n)
@@ -398,6 +415,27 @@ int mclBnG1_hashAndMapToWithDst(mclBnG1 *x, const void *buf, mclSize bufSize, co
 	hashAndMapToG1(*cast(x), buf, bufSize, dst, dstSize);
 	return 0;
 }
+int mclBnG1_hashAndMapToVec(mclBnG1 *x, const void *const *bufVec, const mclSize *bufSizeVec, mclSize n)
+{
+	return mclBnG1_hashAndMapToVecMT(x, bufVec, bufSizeVec, n, 1);
+}
+int mclBnG1_hashAndMapToVecMT(mclBnG1 *x, const void *const *bufVec, const mclSize *bufSizeVec, mclSize n, mclSize cpuN)
+{
+	if (sizeof(mclSize) == sizeof(size_t)) {
+		hashAndMapToG1VecMT(cast(x), bufVec, reinterpret_cast<const size_t*>(bufSizeVec), n, cpuN);
+		return 0;
+	}
+	if (n == 0) return 0;
+	// convert bufSizeVec to size_t
+	size_t *sizeVec = (size_t*)malloc(sizeof(size_t) * n);
+	if (sizeVec == 0) return -1;
+	for (size_t i = 0; i < n; i++) {
+		sizeVec[i] = bufSizeVec[i];
+	}
+	hashAndMapToG1VecMT(cast(x), bufVec, sizeVec, n, cpuN);
+	free(sizeVec);
+	return 0;
+}
 
 mclSize mclBnG1_getStr(char *buf, mclSize maxBufSize, const mclBnG1 *x, int ioMode)
 {
@@ -451,6 +489,13 @@ int mclBnG2_setStr(mclBnG2 *x, const char *buf, mclSize bufSize, int ioMode)
 }
 mclSize mclBnG2_deserialize(mclBnG2 *x, const void *buf, mclSize bufSize)
 {
+#ifdef MCL_USE_G2_CACHE
+	G2Cache& cache = getG2Cache();
+	const size_t n = Fp::getByteSize() * 2; // size of compressed G2
+	if (bufSize >= n && cache.getMaxByte() > 0 && cache.deserialize(*cast(x), buf, n) == n) {
+		return n;
+	}
+#endif
 	return (mclSize)cast(x)->deserialize(buf, bufSize);
 }
 
@@ -482,6 +527,27 @@ int mclBnG2_hashAndMapToWithDst(mclBnG2 *x, const void *buf, mclSize bufSize, co
 	hashAndMapToG2(*cast(x), buf, bufSize, dst, dstSize);
 	return 0;
 }
+int mclBnG2_hashAndMapToVec(mclBnG2 *x, const void *const *bufVec, const mclSize *bufSizeVec, mclSize n)
+{
+	return mclBnG2_hashAndMapToVecMT(x, bufVec, bufSizeVec, n, 1);
+}
+int mclBnG2_hashAndMapToVecMT(mclBnG2 *x, const void *const *bufVec, const mclSize *bufSizeVec, mclSize n, mclSize cpuN)
+{
+	if (sizeof(mclSize) == sizeof(size_t)) {
+		hashAndMapToG2VecMT(cast(x), bufVec, reinterpret_cast<const size_t*>(bufSizeVec), n, cpuN);
+		return 0;
+	}
+	if (n == 0) return 0;
+	// convert bufSizeVec to size_t
+	size_t *sizeVec = (size_t*)malloc(sizeof(size_t) * n);
+	if (sizeVec == 0) return -1;
+	for (size_t i = 0; i < n; i++) {
+		sizeVec[i] = bufSizeVec[i];
+	}
+	hashAndMapToG2VecMT(cast(x), bufVec, sizeVec, n, cpuN);
+	free(sizeVec);
+	return 0;
+}
 
 mclSize mclBnG2_getStr(char *buf, mclSize maxBufSize, const mclBnG2 *x, int ioMode)
 {
@@ -561,6 +627,10 @@ int mclBnGT_isOne(const mclBnGT *x)
 {
 	return cast(x)->isOne();
 }
+int mclBnGT_isValidOrder(const mclBnGT *x)
+{
+	return cast(x)->isValidOrder();
+}
 
 mclSize mclBnGT_getStr(char *buf, mclSize maxBufSize, const mclBnGT *x, int ioMode)
 {
@@ -571,6 +641,18 @@ mclSize mclBnGT_serialize(void *buf, mclSize maxBufSize, const mclBnGT *x)
 {
 	return (mclSize)cast(x)->serialize(buf, maxBufSize);
 }
+mclSize mclBnGT_serializeCompressed(void *buf, mclSize maxBufSize, const mclBnGT *x)
+{
+	return (mclSize)serializeCompressedGT(buf, maxBufSize, *cast(x));
+}
+mclSize mclBnGT_deserializeCompressed(mclBnGT *x, const void *buf, mclSize bufSize)
+{
+	return (mclSize)deserializeCompressedGT(*cast(x), buf, bufSize);
+}
+mclSize mclBnGT_deserializeCompressedVec(mclBnGT *x, const void *buf, mclSize bufSize, mclSize n)
+{
+	return (mclSize)deserializeCompressedGTVec(cast(x), buf, bufSize, n);
+}
 
 void mclBnGT_neg(mclBnGT *y, const mclBnGT *x)
 {
@@ -622,6 +704,16 @@ void mclBnG2_mulVec(mclBnG2 *z, mclBnG2 *x, const mclBnFr *y, mclSize n)
 {
 	G2::mulVec(*cast(z), cast(x), cast(y), n);
 }
+int mclBnG1_mulVecStream(mclBnG1 *z, mclSize (*read)(mclBnG1 *x, mclBnFr *y, mclSize maxN, void *self), void *self, mclSize n)
+{
+	CallbackReader<mclBnG1> reader = { read, self };
+	return mcl::ec::mulVecStream<G1, Fr>(*cast(z), reader, n) ? 0 : -1;
+}
+int mclBnG2_mulVecStream(mclBnG2 *z, mclSize (*read)(mclBnG2 *x, mclBnFr *y, mclSize maxN, void *self), void *self, mclSize n)
+{
+	CallbackReader<mclBnG2> reader = { read, self };
+	return mcl::ec::mulVecStream<G2, Fr>(*cast(z), reader, n) ? 0 : -1;
+}
 void mclBnGT_powVec(mclBnGT *z, const mclBnGT *x, const mclBnFr *y, mclSize n)
 {
 	GT::powVec(*cast(z), cast(x), cast(y), n);
@@ -635,6 +727,14 @@ void mclBn_finalExp(mclBnGT *y, const mclBnGT *x)
 {
 	finalExp(*cast(y), *cast(x));
 }
+void mclBn_finalExpVec(mclBnGT *y, const mclBnGT *x, mclSize n)
+{
+	finalExpVec(cast(y), cast(x), n);
+}
+void mclBn_finalExpVecMT(mclBnGT *y, const mclBnGT *x, mclSize n, mclSize cpuN)
+{
+	finalExpVecMT(cast(y), cast(x), n, cpuN);
+}
 void mclBn_millerLoop(mclBnGT *z, const mclBnG1 *x, const mclBnG2 *y)
 {
 	millerLoop(*cast(z), *cast(x), *cast(y));
@@ -655,6 +755,57 @@ void mclBnG2_mulVecMT(mclBnG2 *z, mclBnG2 *x, const mclBnFr *y, mclSize n, mclSi
 {
 	G2::mulVecMT(*cast(z), cast(x), cast(y), n, cpuN);
 }
+int mclBn_setThreadPoolSize(mclSize n)
+{
+#ifdef MCL_USE_STD_THREAD
+	mcl::setThreadPoolSize(n);
+	return 0;
+#else
+	(void)n;
+	return -1;
+#endif
+}
+int mclBn_setG2CacheMaxByte(mclSize maxByte)
+{
+#ifdef MCL_USE_G2_CACHE
+	getG2Cache().setMaxByte(maxByte);
+	return 0;
+#else
+	(void)maxByte;
+	return -1;
+#endif
+}
+void mclBn_getG2CacheStat(uint64_t *hitNum, uint64_t *missNum, mclSize *byteSize)
+{
+#ifdef MCL_USE_G2_CACHE
+	const G2Cache& cache = getG2Cache();
+	*hitNum = cache.getHitNum();
+	*missNum = cache.getMissNum();
+	*byteSize = cache.getByteSize();
+#else
+	*hitNum = 0;
+	*missNum = 0;
+	*byteSize = 0;
+#endif
+}
+void mclBn_clearG2Cache(void)
+{
+#ifdef MCL_USE_G2_CACHE
+	getG2Cache().clear();
+#endif
+}
+int mclBn_millerLoopCachedG2(mclBnGT *f, const mclBnG1 *P, const void *buf, mclSize bufSize)
+{
+#ifdef MCL_USE_G2_CACHE
+	return getG2Cache().millerLoop(*cast(f), *cast(P), buf, bufSize) ? 0 : -1;
+#else
+	G2 Q;
+	if (Q.deserialize(buf, bufSize) != bufSize) return -1;
+	if (!G2::verifyOrder_ && !Q.isValidOrder()) return -1;
+	millerLoop(*cast(f), *cast(P), Q);
+	return 0;
+#endif
+}
 int mclBn_getUint64NumToPrecompute(void)
 {
 	return int(BN::param.precomputedQcoeffSize * sizeof(Fp6) / sizeof(uint64_t));
@@ -680,6 +831,55 @@ void mclBn_precomputedMillerLoop2mixed(mclBnGT *f, const mclBnG1 *P1, const mclB
 	precomputedMillerLoop2mixed(*cast(f), *cast(P1), *cast(Q1), *cast(P2), cast(Q2buf));
 }
 
+void mclBn_precomputedMillerLoopVec(mclBnGT *f, const mclBnG1 *Pvec, const uint64_t *QbufVec, mclSize n)
+{
+	precomputedMillerLoopVec(*cast(f), cast(Pvec), cast(QbufVec), n);
+}
+
+void mclBn_precomputedMillerLoopVecMixed(mclBnGT *f, const mclBnG1 *P1vec, const mclBnG2 *Q1vec, mclSize n1, const mclBnG1 *P2vec, const uint64_t *Q2bufVec, mclSize n2)
+{
+	precomputedMillerLoopVecMixed(*cast(f), cast(P1vec), cast(Q1vec), n1, cast(P2vec), cast(Q2bufVec), n2);
+}
+int mclBn_getUint64NumToPrecomputeAffine(void)
+{
+	return int(BN::param.precomputedQcoeffSize * 2 * sizeof(Fp2) / sizeof(uint64_t));
+}
+
+void mclBn_precomputeG2Affine(uint64_t *Qbuf, const mclBnG2 *Q)
+{
+	precomputeG2Affine(reinterpret_cast<Fp2*>(Qbuf), *cast(Q));
+}
+
+void mclBn_precomputedMillerLoopAffine(mclBnGT *f, const mclBnG1 *P, const uint64_t *Qbuf)
+{
+	precomputedMillerLoopAffine(*cast(f), *cast(P), reinterpret_cast<const Fp2*>(Qbuf));
+}
+
+void mclBn_precomputedMillerLoopAffineVec(mclBnGT *f, const mclBnG1 *Pvec, const uint64_t *QbufVec, mclSize n)
+{
+	precomputedMillerLoopAffineVec(*cast(f), cast(Pvec), reinterpret_cast<const Fp2*>(QbufVec), n);
+}
+int mclBn_verifyPairingEquations(int *okVec, const mclBnG1 *Pvec, const mclBnG2 *Qvec, const mclSize *nVec, mclSize k)
+{
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+	std::vector<size_t> nv(nVec, nVec + k);
+	bool *ok = okVec ? new bool[k] : 0;
+	const bool ret = verifyPairingEquations(cast(Pvec), cast(Qvec), nv.data(), k, ok);
+	if (ok) {
+		for (size_t i = 0; i < k; i++) okVec[i] = ok[i];
+		delete[] ok;
+	}
+	return ret ? 1 : 0;
+#else
+	(void)okVec;
+	(void)Pvec;
+	(void)Qvec;
+	(void)nVec;
+	(void)k;
+	return -1;
+#endif
+}
+
 int mclBn_FrLagrangeInterpolation(mclBnFr *out, const mclBnFr *xVec, const mclBnFr *yVec, mclSize k)
 {
 	bool b;
@@ -726,6 +926,10 @@ void mclBn_verifyOrderG2(int doVerify)
 {
 	verifyOrderG2(doVerify != 0);
 }
+void mclBn_verifyOrderGT(int doVerify)
+{
+	verifyOrderGT(doVerify != 0);
+}
 
 void mclBnFp_setInt(mclBnFp *y, mclInt x)
 {
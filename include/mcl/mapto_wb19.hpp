@@ -19,6 +19,7 @@ struct PointT {
 	static F a_;
 	static F b_;
 	static int specialA_;
+	static const int mode_ = ec::Jacobi; // for ec::normalizeVec
 	bool isZero() const
 	{
 		return z.isZero();
@@ -41,6 +42,53 @@ template<class F> int PointT<F>::specialA_ = ec::GenericA;
 
 } // mcl::local
 
+/*
+	streaming version of expand_message_xmd
+	update(msg0, size0); update(msg1, size1); ...; digest(out, outSize, dst, dstSize);
+	out = expand_message_xmd(msg0 | msg1 | ..., dst)
+	call clear() before reusing it
+*/
+class ExpandMessageXmd {
+	cybozu::Sha256 h_;
+public:
+	ExpandMessageXmd()
+	{
+		clear();
+	}
+	void clear()
+	{
+		static const uint8_t Z_pad[64] = {};
+		h_.clear();
+		h_.update(Z_pad, sizeof(Z_pad));
+	}
+	void update(const void *msg, size_t msgSize)
+	{
+		h_.update(msg, msgSize);
+	}
+	void digest(uint8_t out[], size_t outSize, const void *dst, size_t dstSize)
+	{
+		const size_t mdSize = 32;
+		uint8_t largeDst[mdSize];
+		if (dstSize > 255) {
+			cybozu::Sha256 h;
+			h.update("H2C-OVERSIZE-DST-", 17);
+			h.digest(largeDst, mdSize, dst, dstSize);
+			dst = largeDst;
+			dstSize = mdSize;
+		}
+		// BE(outSize, 2) | BE(0, 1) | dst | BE(dstSize, 1)
+		uint8_t buf[3];
+		cybozu::Set16bitAsBE(buf, uint16_t(outSize));
+		buf[2] = 0;
+		h_.update(buf, sizeof(buf));
+		h_.update(dst, dstSize);
+		uint8_t dstSizeBuf = uint8_t(dstSize);
+		uint8_t b0[mdSize];
+		h_.digest(b0, mdSize, &dstSizeBuf, 1);
+		mcl::fp::expand_message_xmd_from_b0(out, outSize, b0, dst, dstSize);
+	}
+};
+
 template<class Fp, class G1, class Fp2, class G2>
 struct MapTo_WB19 {
 	typedef local::PointT<Fp> E1;
@@ -285,19 +333,27 @@ struct MapTo_WB19 {
 	// refer (xnum, xden, ynum, yden)
 	void iso3(G2& Q, const E2& P) const
 	{
-		Fp2 zpows[3];
-		Fp2::sqr(zpows[0], P.z);
-		Fp2::sqr(zpows[1], zpows[0]);
-		Fp2::mul(zpows[2], zpows[1], zpows[0]);
 		Fp2 mapvals[4];
-		evalPoly(mapvals[0], P.x, zpows, xnum);
-		evalPoly(mapvals[1], P.x, zpows, xden);
-		evalPoly(mapvals[2], P.x, zpows, ynum);
-		evalPoly(mapvals[3], P.x, zpows, yden);
-		mapvals[1] *= zpows[0];
-		mapvals[2] *= P.y;
-		mapvals[3] *= zpows[0];
-		mapvals[3] *= P.z;
+		if (P.z.isOne()) {
+			mapvals[0] = evalPoly2(P.x, xnum);
+			mapvals[1] = evalPoly2(P.x, xden);
+			mapvals[2] = evalPoly2(P.x, ynum);
+			mapvals[3] = evalPoly2(P.x, yden);
+			mapvals[2] *= P.y;
+		} else {
+			Fp2 zpows[3];
+			Fp2::sqr(zpows[0], P.z);
+			Fp2::sqr(zpows[1], zpows[0]);
+			Fp2::mul(zpows[2], zpows[1], zpows[0]);
+			evalPoly(mapvals[0], P.x, zpows, xnum);
+			evalPoly(mapvals[1], P.x, zpows, xden);
+			evalPoly(mapvals[2], P.x, zpows, ynum);
+			evalPoly(mapvals[3], P.x, zpows, yden);
+			mapvals[1] *= zpows[0];
+			mapvals[2] *= P.y;
+			mapvals[3] *= zpows[0];
+			mapvals[3] *= P.z;
+		}
 		Fp2::mul(Q.z, mapvals[1], mapvals[3]);
 		Fp2::mul(Q.x, mapvals[0], mapvals[3]);
 		Q.x *= Q.z;
@@ -317,25 +373,42 @@ struct MapTo_WB19 {
 		return ret;
 	}
 	// refer (g1xnum, g1xden, g1ynum, g1yden)
-	void iso11(G1& Q, E1& P) const
-	{
-		ec::normalizeJacobi(P);
-		Fp xn, xd, yn, yd;
-		xn = evalPoly2(P.x, g1xnum);
-		xd = evalPoly2(P.x, g1xden);
-		yn = evalPoly2(P.x, g1ynum);
-		yd = evalPoly2(P.x, g1yden);
+	void iso11(G1& Q, const E1& P) const
+	{
+		Fp mapvals[4];
+		if (P.z.isOne()) {
+			mapvals[0] = evalPoly2(P.x, g1xnum);
+			mapvals[1] = evalPoly2(P.x, g1xden);
+			mapvals[2] = evalPoly2(P.x, g1ynum);
+			mapvals[3] = evalPoly2(P.x, g1yden);
+			mapvals[2] *= P.y;
+		} else {
+			// evaluate the polynomials by Jacobi coordinates without inversion
+			Fp zpows[15];
+			Fp::sqr(zpows[0], P.z);
+			for (size_t i = 1; i < CYBOZU_NUM_OF_ARRAY(zpows); i++) {
+				Fp::mul(zpows[i], zpows[i - 1], zpows[0]);
+			}
+			evalPoly(mapvals[0], P.x, zpows, g1xnum);
+			evalPoly(mapvals[1], P.x, zpows, g1xden);
+			evalPoly(mapvals[2], P.x, zpows, g1ynum);
+			evalPoly(mapvals[3], P.x, zpows, g1yden);
+			mapvals[1] *= zpows[0];
+			mapvals[2] *= P.y;
+			mapvals[3] *= zpows[0];
+			mapvals[3] *= P.z;
+		}
 		/*
 			[xn/xd:y * yn/yd:1] = [xn xd yd^2:y yn xd^3 yd^2:xd yd]
 			=[xn yd z:y yn xd z^2:z] where z = xd yd
 		*/
-		Fp::mul(Q.z, xd, yd);
-		Fp::mul(Q.x, xn, yd);
+		Fp::mul(Q.z, mapvals[1], mapvals[3]);
+		Fp::mul(Q.x, mapvals[0], mapvals[3]);
 		Q.x *= Q.z;
-		Fp::mul(Q.y, P.y, yn);
-		Q.y *= xd;
-		Fp::sqr(xd, Q.z);
-		Q.y *= xd;
+		Fp t;
+		Fp::sqr(t, Q.z);
+		Fp::mul(Q.y, mapvals[2], mapvals[1]);
+		Q.y *= t;
 	}
 	/*
 		xi = -2-i
@@ -528,6 +601,10 @@ struct MapTo_WB19 {
 	{
 		uint8_t md[256];
 		mcl::fp::expand_message_xmd(md, sizeof(md), msg, msgSize, dst, dstSize);
+		mdToFp2(out, md);
+	}
+	static void mdToFp2(Fp2 out[2], const uint8_t md[256])
+	{
 		Fp *x = out[0].getFp0();
 		for (size_t i = 0; i < 4; i++) {
 			bool b;
@@ -536,14 +613,65 @@ struct MapTo_WB19 {
 		}
 	}
 	void msgToG2(G2& out, const void *msg, size_t msgSize, const void *dst, size_t dstSize) const
+	{
+		uint8_t md[256];
+		mcl::fp::expand_message_xmd(md, sizeof(md), msg, msgSize, dst, dstSize);
+		mdToG2(out, md);
+	}
+	// md = expand_message_xmd(msg, dst) of 256 bytes
+	void mdToG2(G2& out, const uint8_t md[256]) const
 	{
 		Fp2 t[2];
-		hashToFp2(t, msg, msgSize, dst, dstSize);
+		mdToFp2(t, md);
 		Fp2ToG2(out, t[0], &t[1]);
 	}
 	void msgToG2(G2& out, const void *msg, size_t msgSize) const
 	{
-		msgToG2(out, msg, msgSize, dstG2.dst, dstG1.len);
+		msgToG2(out, msg, msgSize, dstG2.dst, dstG2.len);
+	}
+	/*
+		out[i] = msgToG2(msgVec[i], msgSizeVec[i]) for i = 0, ..., n-1 (n <= N)
+		out[i] are normalized
+		the points are normalized before iso3 and mulByCofactorBLS12fast
+		by one inversion for each step to use the affine formulas
+	*/
+	template<size_t N>
+	void msgToG2VecN(G2 *out, const void *const *msgVec, const size_t *msgSizeVec, size_t n, const void *dst, size_t dstSize) const
+	{
+		assert(n <= N);
+		const size_t mdSize = 256;
+		uint8_t md[N * mdSize];
+		mcl::fp::expand_message_xmdVec(md, mdSize, msgVec, msgSizeVec, n, dst, dstSize);
+		E2 P[N];
+		for (size_t i = 0; i < n; i++) {
+			Fp2 t[2];
+			mdToFp2(t, md + mdSize * i);
+			sswuG2(P[i], t[0]);
+			E2 P2;
+			sswuG2(P2, t[1]);
+			ec::addJacobi(P[i], P[i], P2);
+		}
+		ec::normalizeVec(P, P, n);
+		for (size_t i = 0; i < n; i++) {
+			iso3(out[i], P[i]);
+		}
+		G2::normalizeVec(out, out, n);
+		for (size_t i = 0; i < n; i++) {
+			mcl::local::mulByCofactorBLS12fast(out[i], out[i]);
+		}
+		G2::normalizeVec(out, out, n);
+	}
+	void msgToG2Vec(G2 *out, const void *const *msgVec, const size_t *msgSizeVec, size_t n, const void *dst, size_t dstSize) const
+	{
+		const size_t N = 16;
+		for (size_t i = 0; i < n; i += N) {
+			const size_t m = fp::min_(n - i, N);
+			msgToG2VecN<N>(out + i, msgVec + i, msgSizeVec + i, m, dst, dstSize);
+		}
+	}
+	void msgToG2Vec(G2 *out, const void *const *msgVec, const size_t *msgSizeVec, size_t n) const
+	{
+		msgToG2Vec(out, msgVec, msgSizeVec, n, dstG2.dst, dstG2.len);
 	}
 	void FpToG1(G1& out, const Fp& u0, const Fp *u1 = 0) const
 	{
@@ -555,19 +683,72 @@ struct MapTo_WB19 {
 			ec::addJacobi(P1, P1, P2);
 		}
 		iso11(out, P1);
-		G1::mulGeneric(out, out, g1cofactor);
+		mcl::local::mulByCofactorBLS12fast(out, out);
 	}
 	void msgToG1(G1& out, const void *msg, size_t msgSize, const char *dst, size_t dstSize) const
 	{
 		uint8_t md[128];
 		mcl::fp::expand_message_xmd(md, sizeof(md), msg, msgSize, dst, dstSize);
+		mdToG1(out, md);
+	}
+	// md = expand_message_xmd(msg, dst) of 128 bytes
+	void mdToG1(G1& out, const uint8_t md[128]) const
+	{
 		Fp u[2];
+		mdToFp(u, md);
+		FpToG1(out, u[0], &u[1]);
+	}
+	static void mdToFp(Fp u[2], const uint8_t md[128])
+	{
 		for (size_t i = 0; i < 2; i++) {
 			bool b;
 			u[i].setBigEndianMod(&b, &md[64 * i], 64);
 			assert(b); (void)b;
 		}
-		FpToG1(out, u[0], &u[1]);
+	}
+	/*
+		out[i] = msgToG1(msgVec[i], msgSizeVec[i]) for i = 0, ..., n-1 (n <= N)
+		out[i] are normalized
+		the points are normalized with one inversion before iso11 and before/after the cofactor clearing
+	*/
+	template<size_t N>
+	void msgToG1VecN(G1 *out, const void *const *msgVec, const size_t *msgSizeVec, size_t n, const void *dst, size_t dstSize) const
+	{
+		assert(n <= N);
+		const size_t mdSize = 128;
+		uint8_t md[N * mdSize];
+		mcl::fp::expand_message_xmdVec(md, mdSize, msgVec, msgSizeVec, n, dst, dstSize);
+		E1 P[N];
+		for (size_t i = 0; i < n; i++) {
+			Fp u[2];
+			mdToFp(u, md + mdSize * i);
+			sswuG1(P[i], u[0]);
+			E1 P2;
+			sswuG1(P2, u[1]);
+			ec::addJacobi(P[i], P[i], P2);
+		}
+		ec::normalizeVec(P, P, n);
+		for (size_t i = 0; i < n; i++) {
+			iso11(out[i], P[i]);
+		}
+		// the additions in the cofactor clearing become mixed ones
+		G1::normalizeVec(out, out, n);
+		for (size_t i = 0; i < n; i++) {
+			mcl::local::mulByCofactorBLS12fast(out[i], out[i]);
+		}
+		G1::normalizeVec(out, out, n);
+	}
+	void msgToG1Vec(G1 *out, const void *const *msgVec, const size_t *msgSizeVec, size_t n, const void *dst, size_t dstSize) const
+	{
+		const size_t N = 16;
+		for (size_t i = 0; i < n; i += N) {
+			const size_t m = fp::min_(n - i, N);
+			msgToG1VecN<N>(out + i, msgVec + i, msgSizeVec + i, m, dst, dstSize);
+		}
+	}
+	void msgToG1Vec(G1 *out, const void *const *msgVec, const size_t *msgSizeVec, size_t n) const
+	{
+		msgToG1Vec(out, msgVec, msgSizeVec, n, dstG1.dst, dstG1.len);
 	}
 
 	void msgToG1(G1& out, const void *msg, size_t msgSize) const
@@ -540,9 +540,7 @@ private:
 	}
 	static void finalExp4(GT out[4], const GT in[4])
 	{
-		for (int i =  0; i < 4; i++) {
-			finalExp(out[i], in[i]);
-		}
+		finalExpVec(out, in, 4);
 	}
 	static void tensorProductML(GT g[4], const G1& S1, const G1& T1, const G2& S2, const G2& T2)
 	{
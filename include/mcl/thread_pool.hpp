@@ -0,0 +1,301 @@
+#pragma once
+/**
+	@file
+	@brief work-stealing thread pool
+	@license modified new BSD license
+	http://opensource.org/licenses/BSD-3-Clause
+	@note C++11 is required
+*/
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <memory>
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+#include <exception>
+#endif
+
+namespace mcl {
+
+/*
+	each worker has its own task queue
+	a worker pops a task from the front of its queue and steals one from the back of the others if empty
+	the thread calling run() also runs tasks until all of its tasks are done,
+	so run() may be called in a task
+*/
+class ThreadPool {
+	typedef std::function<void()> Task;
+	struct Queue {
+		std::mutex m;
+		std::deque<Task> q;
+	};
+	std::vector<std::thread> threads_;
+	std::vector<std::unique_ptr<Queue> > queues_;
+	std::mutex m_;
+	std::condition_variable cv_;
+	std::atomic<size_t> taskN_; // num of tasks in queues_
+	std::atomic<size_t> pos_; // the queue where the next run() starts to push
+	bool quit_;
+	ThreadPool(const ThreadPool&);
+	void operator=(const ThreadPool&);
+	void push(size_t idx, Task&& t)
+	{
+		Queue& q = *queues_[idx];
+		{
+			std::lock_guard<std::mutex> lk(q.m);
+			q.q.push_back(std::move(t));
+		}
+		{
+			std::lock_guard<std::mutex> lk(m_);
+			taskN_++;
+		}
+		cv_.notify_one();
+	}
+	bool popSub(Task& t, size_t idx, bool front)
+	{
+		Queue& q = *queues_[idx];
+		std::lock_guard<std::mutex> lk(q.m);
+		if (q.q.empty()) return false;
+		if (front) {
+			t = std::move(q.q.front());
+			q.q.pop_front();
+		} else {
+			t = std::move(q.q.back());
+			q.q.pop_back();
+		}
+		taskN_--;
+		return true;
+	}
+	// self = queues_.size() for a thread out of the pool
+	bool pop(Task& t, size_t self)
+	{
+		const size_t qN = queues_.size();
+		if (self < qN && popSub(t, self, true)) return true;
+		const size_t start = self < qN ? self + 1 : pos_.load();
+		for (size_t i = 0; i < qN; i++) {
+			if (popSub(t, (start + i) % qN, false)) return true;
+		}
+		return false;
+	}
+	void worker(size_t idx)
+	{
+		Task t;
+		for (;;) {
+			if (pop(t, idx)) {
+				t();
+				t = nullptr;
+				continue;
+			}
+			std::unique_lock<std::mutex> lk(m_);
+			cv_.wait(lk, [this] { return quit_ || taskN_ > 0; });
+			if (quit_ && taskN_ == 0) return;
+		}
+	}
+	void destroy()
+	{
+		{
+			std::lock_guard<std::mutex> lk(m_);
+			quit_ = true;
+		}
+		cv_.notify_all();
+		for (size_t i = 0; i < threads_.size(); i++) {
+			threads_[i].join();
+		}
+		threads_.clear();
+		queues_.clear();
+	}
+public:
+	// threadN = 0 means the num of hardware threads
+	explicit ThreadPool(size_t threadN = 0)
+		: taskN_(0)
+		, pos_(0)
+		, quit_(false)
+	{
+		init(threadN);
+	}
+	~ThreadPool()
+	{
+		destroy();
+	}
+	static size_t getDefaultThreadNum()
+	{
+		size_t n = std::thread::hardware_concurrency();
+		return n ? n : 1;
+	}
+	/*
+		threadN : num of threads running tasks including the caller of run()
+		do not call this while run() is running
+	*/
+	void init(size_t threadN = 0)
+	{
+		destroy();
+		quit_ = false;
+		if (threadN == 0) threadN = getDefaultThreadNum();
+		const size_t workerN = threadN - 1;
+		for (size_t i = 0; i < workerN; i++) {
+			queues_.push_back(std::unique_ptr<Queue>(new Queue()));
+		}
+		for (size_t i = 0; i < workerN; i++) {
+			threads_.push_back(std::thread(&ThreadPool::worker, this, i));
+		}
+	}
+	size_t getThreadNum() const { return threads_.size() + 1; }
+	/*
+		return the num of tasks to split n elements
+		each task has at least minN elements if possible
+		cpuN = 0 means getThreadNum()
+	*/
+	size_t getTaskNum(size_t n, size_t minN, size_t cpuN = 0) const
+	{
+		if (cpuN == 0) {
+			cpuN = getThreadNum();
+			if (n < minN * cpuN) {
+				cpuN = (n + minN - 1) / minN;
+			}
+		}
+		if (n <= cpuN) return 1;
+		return cpuN;
+	}
+	/*
+		call f(i) for i = 0, ..., n - 1 in parallel and wait for all of them
+		if some f(i) throw, the first exception is rethrown after all of them are done
+		the caller runs the queued tasks and sleeps if there is no task to run
+	*/
+	template<class F>
+	void run(size_t n, const F& f)
+	{
+		if (threads_.empty() || n <= 1) {
+			for (size_t i = 0; i < n; i++) {
+				f(i);
+			}
+			return;
+		}
+		// remain is protected by m and cv is notified when it becomes 0
+		std::mutex m;
+		std::condition_variable cv;
+		size_t remain = n;
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+		std::exception_ptr err;
+#endif
+		// notify with the lock held so that the caller does not return (and destroy m) before it
+		auto done = [&](size_t k) {
+			std::lock_guard<std::mutex> lk(m);
+			remain -= k;
+			if (remain == 0) cv.notify_one();
+		};
+		// the tasks refer to the local variables, so call must not throw
+		auto call = [&](size_t i) {
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+			try {
+				f(i);
+			} catch (...) {
+				std::lock_guard<std::mutex> lk(m);
+				if (!err) err = std::current_exception();
+			}
+#else
+			f(i);
+#endif
+			done(1);
+		};
+		const size_t qN = queues_.size();
+		const size_t start = pos_++;
+		size_t pushed = 1;
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+		try {
+#endif
+			for (; pushed < n; pushed++) {
+				push((start + pushed) % qN, [&call, pushed] { call(pushed); });
+			}
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+		} catch (...) {
+			std::lock_guard<std::mutex> lk(m);
+			if (!err) err = std::current_exception();
+		}
+#endif
+		if (pushed == n) {
+			call(0);
+		} else {
+			// wait for the pushed tasks only
+			done(n - pushed + 1);
+		}
+		/*
+			if pop fails, all the tasks of this run have been taken by some threads
+			and they finish without this thread, so it is safe to sleep
+		*/
+		Task t;
+		for (;;) {
+			{
+				std::lock_guard<std::mutex> lk(m);
+				if (remain == 0) break;
+			}
+			if (pop(t, qN)) {
+				t();
+				t = nullptr;
+				continue;
+			}
+			std::unique_lock<std::mutex> lk(m);
+			cv.wait(lk, [&] { return remain == 0; });
+			break;
+		}
+#ifndef CYBOZU_DONT_USE_EXCEPTION
+		if (err) std::rethrow_exception(err);
+#endif
+	}
+};
+
+namespace local {
+
+struct ThreadPoolHolder {
+	std::mutex m;
+	std::unique_ptr<ThreadPool> pool;
+	std::atomic<ThreadPool*> p; // pool.get() for the fast path of getThreadPool
+	ThreadPoolHolder() : p(nullptr) {}
+	static ThreadPoolHolder& get()
+	{
+		static ThreadPoolHolder holder;
+		return holder;
+	}
+	// call this with m locked
+	void make(size_t n)
+	{
+		pool.reset(new ThreadPool(n));
+		p.store(pool.get(), std::memory_order_release);
+	}
+};
+
+} // mcl::local
+
+/*
+	the pool used by mulVecMT and millerLoopVecMT
+	it is made with the num of hardware threads at the first call
+*/
+inline ThreadPool& getThreadPool()
+{
+	local::ThreadPoolHolder& h = local::ThreadPoolHolder::get();
+	ThreadPool *p = h.p.load(std::memory_order_acquire);
+	if (p) return *p;
+	std::lock_guard<std::mutex> lk(h.m);
+	if (!h.pool) h.make(0);
+	return *h.pool;
+}
+
+/*
+	set the num of threads (including the caller) of getThreadPool()
+	n = 0 means the num of hardware threads
+	do not call this while the pool is used
+*/
+inline void setThreadPoolSize(size_t n)
+{
+	local::ThreadPoolHolder& h = local::ThreadPoolHolder::get();
+	std::lock_guard<std::mutex> lk(h.m);
+	if (h.pool) {
+		h.pool->init(n);
+	} else {
+		h.make(n);
+	}
+}
+
+} // mcl
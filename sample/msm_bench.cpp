@@ -0,0 +1,306 @@
+/*
+	benchmark of G1::mulVec, G2::mulVec and GT::powVec
+	sweep n = 2^min, ..., 2^max (div points per octave), curves and thread counts
+	and put one record per line as CSV (default) or JSON
+
+	msm_bench -min 4 -max 22 -curve bn254 bls12_381 -cpu 1 2 4 0 -json
+
+	columns
+	curve, op, n, cpuN(0 = all cores), loop : setting
+	ns_per_op : wall clock time of one call of mulVec/powVec
+	ns_per_point : ns_per_op / n
+	cycles_per_point : by rdtsc (0 if not available)
+	peak_rss_kb : peak resident set size of the process (0 if not available)
+	ok : true if the result is equal to the reference else false
+	     the reference is a naive loop of G::mul/GT::pow if n <= naiveN (-naive)
+	     else the result of G::mulVec for cpuN != 1 (n/a for cpuN = 1 and GT::powVec)
+*/
+#include <mcl/bls12_381.hpp>
+#include <cybozu/option.hpp>
+#include <cybozu/xorshift.hpp>
+#include <chrono>
+#include <math.h>
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+	#include <x86intrin.h>
+#endif
+#ifndef _WIN32
+	#include <sys/resource.h>
+#endif
+
+using namespace mcl::bn;
+
+uint64_t getCycle()
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+size_t getPeakRssKB()
+{
+#ifdef _WIN32
+	return 0;
+#else
+	struct rusage ru;
+	if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+#ifdef __APPLE__
+	return size_t(ru.ru_maxrss / 1024); // bytes
+#else
+	return size_t(ru.ru_maxrss); // KB
+#endif
+#endif
+}
+
+struct Result {
+	int loop;
+	double nsec;
+	double cycle;
+};
+
+/*
+	call f() until total time exceeds minSec or loop reaches maxLoop
+*/
+template<class F>
+Result measure(F f, double minSec, int maxLoop)
+{
+	typedef std::chrono::steady_clock Clock;
+	Result r;
+	r.loop = 0;
+	const Clock::time_point begin = Clock::now();
+	const uint64_t c0 = getCycle();
+	double sec = 0;
+	do {
+		f();
+		r.loop++;
+		sec = std::chrono::duration<double>(Clock::now() - begin).count();
+	} while (sec < minSec && r.loop < maxLoop);
+	r.cycle = double(getCycle() - c0) / r.loop;
+	r.nsec = sec * 1e9 / r.loop;
+	return r;
+}
+
+// the value of ok column
+enum Check {
+	CheckNA = -1,
+	CheckNG = 0,
+	CheckOK = 1
+};
+
+Check getCheck(bool b)
+{
+	return b ? CheckOK : CheckNG;
+}
+
+struct Printer {
+	bool json;
+	const char *curve;
+	explicit Printer(bool json) : json(json), curve("") {}
+	void header() const
+	{
+		if (json) return;
+		printf("curve,op,n,cpuN,loop,ns_per_op,ns_per_point,cycles_per_point,peak_rss_kb,ok\n");
+	}
+	void put(const char *op, size_t n, size_t cpuN, const Result& r, Check ok) const
+	{
+		const size_t rss = getPeakRssKB();
+		const char *okStr = ok == CheckOK ? "true" : ok == CheckNG ? "false" : json ? "null" : "n/a";
+		if (json) {
+			printf("{\"curve\":\"%s\",\"op\":\"%s\",\"n\":%zd,\"cpuN\":%zd,\"loop\":%d,\"ns_per_op\":%.0f,\"ns_per_point\":%.2f,\"cycles_per_point\":%.2f,\"peak_rss_kb\":%zd,\"ok\":%s}\n",
+				curve, op, n, cpuN, r.loop, r.nsec, r.nsec / n, r.cycle / n, rss, okStr);
+		} else {
+			printf("%s,%s,%zd,%zd,%d,%.0f,%.2f,%.2f,%zd,%s\n",
+				curve, op, n, cpuN, r.loop, r.nsec, r.nsec / n, r.cycle / n, rss, okStr);
+		}
+		fflush(stdout);
+	}
+};
+
+struct Config {
+	std::vector<size_t> nTbl;
+	std::vector<size_t> cpuTbl;
+	double minSec;
+	int maxLoop;
+	size_t naiveN;
+	bool g1, g2, gt;
+};
+
+/*
+	xVec[i] = P * (i + 1) (not normalized as the output of a usual computation)
+*/
+template<class G>
+void initPoints(std::vector<G>& xVec, const G& P)
+{
+	xVec[0] = P;
+	for (size_t i = 1; i < xVec.size(); i++) {
+		G::add(xVec[i], xVec[i - 1], P);
+	}
+}
+
+// z = sum_{i=0}^{n-1} xVec[i] yVec[i] by G::mul
+template<class G>
+void mulVecNaive(G& z, const G *xVec, const Fr *yVec, size_t n)
+{
+	z.clear();
+	for (size_t i = 0; i < n; i++) {
+		G t;
+		G::mul(t, xVec[i], yVec[i]);
+		z += t;
+	}
+}
+
+template<class G>
+void benchMulVec(const Printer& pr, const char *op, const G& P, const std::vector<Fr>& yVec, const Config& cfg)
+{
+	const size_t maxN = cfg.nTbl.back();
+	std::vector<G> xVec(maxN);
+	initPoints(xVec, P);
+	for (size_t i = 0; i < cfg.nTbl.size(); i++) {
+		const size_t n = cfg.nTbl[i];
+		const bool isNaive = n <= cfg.naiveN;
+		G Q1, Q2;
+		if (isNaive) {
+			mulVecNaive(Q1, xVec.data(), yVec.data(), n);
+		} else {
+			G::mulVec(Q1, xVec.data(), yVec.data(), n, false);
+		}
+		for (size_t j = 0; j < cfg.cpuTbl.size(); j++) {
+			const size_t cpuN = cfg.cpuTbl[j];
+			Result r;
+			Check ok;
+			if (cpuN == 1) {
+				r = measure([&]() { G::mulVec(Q2, xVec.data(), yVec.data(), n, false); }, cfg.minSec, cfg.maxLoop);
+				ok = isNaive ? getCheck(Q1 == Q2) : CheckNA;
+			} else {
+				r = measure([&]() { G::mulVecMT(Q2, xVec.data(), yVec.data(), n, cpuN, false); }, cfg.minSec, cfg.maxLoop);
+				ok = getCheck(Q1 == Q2);
+			}
+			pr.put(op, n, cpuN, r, ok);
+		}
+	}
+}
+
+void benchPowVec(const Printer& pr, const GT& e, const std::vector<Fr>& yVec, const Config& cfg)
+{
+	const size_t maxN = cfg.nTbl.back();
+	std::vector<GT> xVec(maxN);
+	xVec[0] = e;
+	for (size_t i = 1; i < maxN; i++) {
+		GT::mul(xVec[i], xVec[i - 1], e);
+	}
+	for (size_t i = 0; i < cfg.nTbl.size(); i++) {
+		const size_t n = cfg.nTbl[i];
+		GT z;
+		// GT::powVec has no multi-thread version
+		Result r = measure([&]() { GT::powVec(z, xVec.data(), yVec.data(), n); }, cfg.minSec, cfg.maxLoop);
+		Check ok = CheckNA;
+		if (n <= cfg.naiveN) {
+			GT z2 = 1;
+			for (size_t j = 0; j < n; j++) {
+				GT t;
+				GT::pow(t, xVec[j], yVec[j]);
+				z2 *= t;
+			}
+			ok = getCheck(z == z2);
+		}
+		pr.put("GT::powVec", n, 1, r, ok);
+	}
+}
+
+void benchCurve(const Printer& pr, const mcl::CurveParam& cp, const Config& cfg)
+{
+	initPairing(cp);
+	cybozu::XorShift rg;
+	std::vector<Fr> yVec(cfg.nTbl.back());
+	for (size_t i = 0; i < yVec.size(); i++) {
+		yVec[i].setByCSPRNG(rg);
+	}
+	G1 P;
+	G2 Q;
+	hashAndMapToG1(P, "abc", 3);
+	hashAndMapToG2(Q, "abc", 3);
+	if (cfg.g1) benchMulVec(pr, "G1::mulVec", P, yVec, cfg);
+	if (cfg.g2) benchMulVec(pr, "G2::mulVec", Q, yVec, cfg);
+	if (cfg.gt) {
+		GT e;
+		pairing(e, P, Q);
+		benchPowVec(pr, e, yVec, cfg);
+	}
+}
+
+int main(int argc, char *argv[])
+	try
+{
+	cybozu::Option opt;
+	size_t minLog, maxLog, div;
+	std::vector<std::string> curveTbl;
+	std::vector<std::string> opTbl;
+	Config cfg;
+	bool json;
+	opt.appendOpt(&minLog, 4, "min", ": n = 2^min, ..., 2^max");
+	opt.appendOpt(&maxLog, 16, "max", ": n = 2^min, ..., 2^max");
+	opt.appendOpt(&div, 1, "div", ": num of points per octave (to find the crossover points)");
+	opt.appendVec(&curveTbl, "curve", ": bn254 bls12_381 (default both)");
+	opt.appendVec(&opTbl, "op", ": g1 g2 gt (default all)");
+	opt.appendVec(&cfg.cpuTbl, "cpu", ": num of threads (0 = all cores, default 1 0)");
+	opt.appendOpt(&cfg.minSec, 0.5, "sec", ": min time (sec) to measure each setting");
+	opt.appendOpt(&cfg.maxLoop, 1000, "loop", ": max loop count of each setting");
+	opt.appendOpt(&cfg.naiveN, 1024, "naive", ": check the results by a naive loop if n <= naive");
+	opt.appendBoolOpt(&json, "json", ": put JSON lines instead of CSV");
+	opt.appendHelp("h");
+	if (!opt.parse(argc, argv) || minLog > maxLog || maxLog >= 32 || div == 0) {
+		opt.usage();
+		return 1;
+	}
+	if (curveTbl.empty()) {
+		curveTbl.push_back("bn254");
+		curveTbl.push_back("bls12_381");
+	}
+	if (opTbl.empty()) {
+		opTbl.push_back("g1");
+		opTbl.push_back("g2");
+		opTbl.push_back("gt");
+	}
+	if (cfg.cpuTbl.empty()) {
+		cfg.cpuTbl.push_back(1);
+		cfg.cpuTbl.push_back(0);
+	}
+	cfg.g1 = cfg.g2 = cfg.gt = false;
+	for (size_t i = 0; i < opTbl.size(); i++) {
+		if (opTbl[i] == "g1") {
+			cfg.g1 = true;
+		} else if (opTbl[i] == "g2") {
+			cfg.g2 = true;
+		} else if (opTbl[i] == "gt") {
+			cfg.gt = true;
+		} else {
+			fprintf(stderr, "bad op %s\n", opTbl[i].c_str());
+			return 1;
+		}
+	}
+	for (size_t i = minLog * div; i <= maxLog * div; i++) {
+		const size_t n = size_t(pow(2.0, double(i) / div) + 0.5);
+		if (cfg.nTbl.empty() || cfg.nTbl.back() < n) cfg.nTbl.push_back(n);
+	}
+	Printer pr(json);
+	pr.header();
+	for (size_t i = 0; i < curveTbl.size(); i++) {
+		const mcl::CurveParam *cp;
+		if (curveTbl[i] == "bn254") {
+			cp = &mcl::BN254;
+		} else if (curveTbl[i] == "bls12_381") {
+			cp = &mcl::BLS12_381;
+		} else {
+			fprintf(stderr, "bad curve %s\n", curveTbl[i].c_str());
+			return 1;
+		}
+		pr.curve = curveTbl[i].c_str();
+		benchCurve(pr, *cp, cfg);
+	}
+} catch (std::exception& e) {
+	printf("err %s\n", e.what());
+	return 1;
+}
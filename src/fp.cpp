@@ -18,6 +18,7 @@
 
 #include "xbyak/xbyak_util.h"
 Xbyak::util::Cpu g_cpu;
+#define MCL_HAS_G_CPU
 
 #ifdef MCL_STATIC_CODE
 #include "fp_static_code.hpp"
@@ -33,6 +34,8 @@ Xbyak::util::Cpu g_cpu;
 #include <cybozu/itoa.hpp>
 #include <mcl/randgen.hpp>
 #include "llvm_proto.hpp"
+#include "sha256_mb.hpp"
+#include "sha256_ni.hpp"
 
 #ifdef _MSC_VER
 	#pragma warning(disable : 4127)
@@ -146,12 +149,38 @@ uint32_t sha512(void *out, uint32_t maxOutSize, const void *msg, uint32_t msgSiz
 	return (uint32_t)cybozu::Sha512().digest(out, maxOutSize, msg, msgSize);
 }
 
+void expand_message_xmd_from_b0(uint8_t out[], size_t outSize, const uint8_t b0[32], const void *dst, size_t dstSize)
+{
+	const size_t mdSize = 32;
+	assert((outSize % mdSize) == 0 && 0 < outSize && outSize <= 256);
+	assert(dstSize <= 255);
+	const size_t n = outSize / mdSize;
+	uint8_t dstSizeBuf = uint8_t(dstSize);
+	cybozu::Sha256 h;
+	h.update(b0, mdSize);
+	uint8_t iBuf = 1;
+	h.update(&iBuf, 1);
+	h.update(dst, dstSize);
+	h.digest(out, mdSize, &dstSizeBuf, 1);
+	uint8_t mdXor[mdSize];
+	for (size_t i = 1; i < n; i++) {
+		h.clear();
+		for (size_t j = 0; j < mdSize; j++) {
+			mdXor[j] = b0[j] ^ out[mdSize * (i - 1) + j];
+		}
+		h.update(mdXor, mdSize);
+		iBuf = uint8_t(i + 1);
+		h.update(&iBuf, 1);
+		h.update(dst, dstSize);
+		h.digest(out + mdSize * i, mdSize, &dstSizeBuf, 1);
+	}
+}
+
 void expand_message_xmd(uint8_t out[], size_t outSize, const void *msg, size_t msgSize, const void *dst, size_t dstSize)
 {
 	const size_t mdSize = 32;
 	assert((outSize % mdSize) == 0 && 0 < outSize && outSize <= 256);
 	const size_t r_in_bytes = 64;
-	const size_t n = outSize / mdSize;
 	static const uint8_t Z_pad[r_in_bytes] = {};
 	uint8_t largeDst[mdSize];
 	if (dstSize > 255) {
@@ -176,23 +205,133 @@ void expand_message_xmd(uint8_t out[], size_t outSize, const void *msg, size_t m
 	h.update(dst, dstSize);
 	uint8_t md[mdSize];
 	h.digest(md, mdSize, &dstSizeBuf, 1);
-	h.clear();
-	h.update(md, mdSize);
-	iBuf = 1;
-	h.update(&iBuf, 1);
-	h.update(dst, dstSize);
-	h.digest(out, mdSize, &dstSizeBuf, 1);
-	uint8_t mdXor[mdSize];
-	for (size_t i = 1; i < n; i++) {
-		h.clear();
-		for (size_t j = 0; j < mdSize; j++) {
-			mdXor[j] = md[j] ^ out[mdSize * (i - 1) + j];
+	expand_message_xmd_from_b0(out, outSize, md, dst, dstSize);
+}
+
+#if defined(MCL_SHA256_NI) && defined(MCL_HAS_G_CPU) && !defined(CYBOZU_USE_OPENSSL_SHA)
+/*
+	use SHA extensions for cybozu::Sha256 if available
+	g_cpu is initialized before it because they are in the same file
+*/
+static struct Sha256NiInit {
+	Sha256NiInit()
+	{
+		using namespace Xbyak::util;
+		if (g_cpu.has(Cpu::tSHA | Cpu::tSSE41)) {
+			cybozu::Sha256::setBlockFunc(sha256_ni::blockFunc);
 		}
-		h.update(mdXor, mdSize);
-		iBuf = uint8_t(i + 1);
-		h.update(&iBuf, 1);
-		h.update(dst, dstSize);
-		h.digest(out + mdSize * i, mdSize, &dstSizeBuf, 1);
+	}
+} s_sha256NiInit;
+#endif
+
+/*
+	md[i * 32] = SHA-256 of the i-th message of in for i = 0, ..., n-1
+	use 16 lanes if AVX-512 is available
+	use 8 lanes if AVX2 is available and SHA extensions are not
+	(16 lanes > SHA extensions > 8 lanes in speed)
+*/
+static void sha256Vec(uint8_t *md, sha256_mb::Input in, size_t n)
+{
+#if defined(MCL_SHA256_MB) && defined(MCL_HAS_G_CPU)
+	using namespace Xbyak::util;
+	if (g_cpu.has(Cpu::tAVX512F) || (g_cpu.has(Cpu::tAVX2) && !g_cpu.has(Cpu::tSHA))) {
+		const bool useAVX512 = g_cpu.has(Cpu::tAVX512F);
+		const size_t N = useAVX512 ? sha256_mb::laneNumAVX512 : sha256_mb::laneNumAVX2;
+		while (n > 0) {
+			const size_t m = fp::min_(n, N);
+			if (useAVX512) {
+				sha256_mb::hashAVX512(md, in, m);
+			} else {
+				sha256_mb::hashAVX2(md, in, m);
+			}
+			md += sha256_mb::mdSize * m;
+			in.msgVec += m;
+			in.msgSizeVec += m;
+			n -= m;
+		}
+		return;
+	}
+#endif
+	for (size_t i = 0; i < n; i++) {
+		cybozu::Sha256 h;
+		h.update(in.prefix, in.prefixSize);
+		h.update(in.msgVec[i], in.msgSizeVec[i]);
+		h.digest(md + sha256_mb::mdSize * i, sha256_mb::mdSize, in.suffix, in.suffixSize);
+	}
+}
+
+void expand_message_xmdVec(uint8_t *outVec, size_t outSize, const void *const *msgVec, const size_t *msgSizeVec, size_t n, const void *dst, size_t dstSize)
+{
+	const size_t mdSize = 32;
+	assert((outSize % mdSize) == 0 && 0 < outSize && outSize <= 256);
+	const size_t r_in_bytes = 64;
+	const size_t N = 16;
+	static const uint8_t Z_pad[r_in_bytes] = {};
+	uint8_t largeDst[mdSize];
+	if (dstSize > 255) {
+		cybozu::Sha256 h;
+		h.update("H2C-OVERSIZE-DST-", 17);
+		h.digest(largeDst, mdSize, dst, dstSize);
+		dst = largeDst;
+		dstSize = mdSize;
+	}
+	/*
+		suffix = BE(outSize, 2) | BE(i, 1) | DST | BE(dstSize, 1)
+		b_0 = H(Z_pad | msg | suffix) with i = 0
+		b_1 = H(b_0 | suffix[2:]) with i = 1
+		b_i = H((b_0 ^ b_{i-1}) | suffix[2:])
+	*/
+	uint8_t suffix[2 + 1 + 255 + 1];
+	cybozu::Set16bitAsBE(suffix, uint16_t(outSize));
+	memcpy(suffix + 3, dst, dstSize);
+	suffix[3 + dstSize] = uint8_t(dstSize);
+	uint8_t b0[N][mdSize];
+	uint8_t bi[N][mdSize];
+	uint8_t md[N][mdSize];
+	const uint8_t *bPtr[N];
+	size_t bSize[N];
+	for (size_t j = 0; j < N; j++) {
+		bSize[j] = mdSize;
+	}
+	while (n > 0) {
+		const size_t m = fp::min_(n, N);
+		sha256_mb::Input in;
+		in.prefix = Z_pad;
+		in.prefixSize = r_in_bytes;
+		in.msgVec = (const uint8_t *const *)msgVec;
+		in.msgSizeVec = msgSizeVec;
+		in.suffix = suffix;
+		in.suffixSize = 2 + 1 + dstSize + 1;
+		suffix[2] = 0;
+		sha256Vec(b0[0], in, m);
+		in.prefix = 0;
+		in.prefixSize = 0;
+		in.msgVec = bPtr;
+		in.msgSizeVec = bSize;
+		in.suffix = suffix + 2;
+		in.suffixSize = 1 + dstSize + 1;
+		for (size_t i = 0; i < outSize / mdSize; i++) {
+			for (size_t j = 0; j < m; j++) {
+				if (i == 0) {
+					bPtr[j] = b0[j];
+				} else {
+					const uint8_t *prev = outVec + outSize * j + mdSize * (i - 1);
+					for (size_t k = 0; k < mdSize; k++) {
+						bi[j][k] = b0[j][k] ^ prev[k];
+					}
+					bPtr[j] = bi[j];
+				}
+			}
+			suffix[2] = uint8_t(i + 1);
+			sha256Vec(md[0], in, m);
+			for (size_t j = 0; j < m; j++) {
+				memcpy(outVec + outSize * j + mdSize * i, md[j], mdSize);
+			}
+		}
+		outVec += outSize * m;
+		msgVec += m;
+		msgSizeVec += m;
+		n -= m;
 	}
 }
 
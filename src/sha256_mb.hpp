@@ -0,0 +1,174 @@
+#pragma once
+/**
+	@file
+	@brief multi-buffer SHA-256 (8 lanes by AVX2 / 16 lanes by AVX-512)
+	@license modified new BSD license
+	http://opensource.org/licenses/BSD-3-Clause
+	each lane of a vector computes SHA-256 of a different message
+	the lanes are written by the vector extension of gcc/clang
+	and compiled for AVX2 or AVX-512 by the target attribute
+	the caller must check the CPU before calling hashAVX2/hashAVX512
+*/
+#include <cybozu/endian.hpp>
+#include <memory.h>
+#include <assert.h>
+
+namespace mcl { namespace sha256_mb {
+
+static const size_t mdSize = 32;
+static const size_t blockSize = 64;
+
+/*
+	md[i] = SHA-256(prefix | msgVec[i] | suffix) for i = 0, ..., n-1
+	prefix and suffix are common for all messages
+*/
+struct Input {
+	const uint8_t *prefix;
+	size_t prefixSize;
+	const uint8_t *const *msgVec;
+	const size_t *msgSizeVec;
+	const uint8_t *suffix;
+	size_t suffixSize;
+	size_t getTotalSize(size_t i) const
+	{
+		return prefixSize + msgSizeVec[i] + suffixSize;
+	}
+	static size_t getBlockNum(size_t totalSize)
+	{
+		// 0x80 and the 64-bit length
+		return (totalSize + 9 + blockSize - 1) / blockSize;
+	}
+	// blk = the b-th padded block of the i-th message
+	void getBlock(uint8_t blk[blockSize], size_t i, size_t b) const
+	{
+		const uint8_t *seg[3] = { prefix, msgVec[i], suffix };
+		const size_t segSize[3] = { prefixSize, msgSizeVec[i], suffixSize };
+		const size_t begin = b * blockSize;
+		const size_t end = begin + blockSize;
+		memset(blk, 0, blockSize);
+		size_t off = 0;
+		for (size_t k = 0; k < 3; k++) {
+			const size_t s = begin > off ? begin : off;
+			const size_t e = end < off + segSize[k] ? end : off + segSize[k];
+			if (s < e) memcpy(blk + (s - begin), seg[k] + (s - off), e - s);
+			off += segSize[k];
+		}
+		if (begin <= off && off < end) blk[off - begin] = 0x80;
+		if (b + 1 == getBlockNum(off)) {
+			cybozu::Set64bitAsBE(blk + blockSize - 8, uint64_t(off) * 8);
+		}
+	}
+};
+
+#if (defined(__GNUC__) || defined(__clang__)) && (CYBOZU_HOST == CYBOZU_HOST_INTEL) && (CYBOZU_OS_BIT == 64)
+	#define MCL_SHA256_MB
+
+#define MCL_SHA256_MB_INLINE inline __attribute__((always_inline))
+
+typedef uint32_t Vec8 __attribute__((vector_size(32)));
+typedef uint32_t Vec16 __attribute__((vector_size(64)));
+
+// a macro instead of a function returning a vector to avoid -Wpsabi
+#define MCL_SHA256_MB_ROTR(x, s) (((x) >> (s)) | ((x) << (32 - (s))))
+
+// h[8] is updated by one block w[16] for all lanes
+template<class V>
+MCL_SHA256_MB_INLINE void compress(V *h, V *w)
+{
+	static const uint32_t kTbl[] = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+	};
+	V a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+	for (int i = 0; i < 64; i++) {
+		if (i >= 16) {
+			const V& t0 = w[(i - 15) & 15];
+			const V& t1 = w[(i - 2) & 15];
+			V s0 = MCL_SHA256_MB_ROTR(t0, 7) ^ MCL_SHA256_MB_ROTR(t0, 18) ^ (t0 >> 3);
+			V s1 = MCL_SHA256_MB_ROTR(t1, 17) ^ MCL_SHA256_MB_ROTR(t1, 19) ^ (t1 >> 10);
+			w[i & 15] += s0 + w[(i - 7) & 15] + s1;
+		}
+		V t1 = hh + (MCL_SHA256_MB_ROTR(e, 6) ^ MCL_SHA256_MB_ROTR(e, 11) ^ MCL_SHA256_MB_ROTR(e, 25)) + (g ^ (e & (f ^ g))) + kTbl[i] + w[i & 15];
+		V t2 = (MCL_SHA256_MB_ROTR(a, 2) ^ MCL_SHA256_MB_ROTR(a, 13) ^ MCL_SHA256_MB_ROTR(a, 22)) + (((a | b) & c) | (a & b));
+		hh = g;
+		g = f;
+		f = e;
+		e = d + t1;
+		d = c;
+		c = b;
+		b = a;
+		a = t1 + t2;
+	}
+	h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+	h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+}
+
+/*
+	md[i * mdSize] = SHA-256 of the i-th message of in for i = 0, ..., n-1 (n <= N)
+	the lanes of the finished messages are computed but not used
+*/
+template<class V, size_t N>
+MCL_SHA256_MB_INLINE void hashN(uint8_t *md, const Input& in, size_t n)
+{
+	assert(n <= N);
+	static const uint32_t iv[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+	};
+	const V zero = {};
+	V h[8];
+	for (int i = 0; i < 8; i++) {
+		h[i] = zero + iv[i];
+	}
+	size_t blockNum[N];
+	size_t maxBlockNum = 0;
+	for (size_t j = 0; j < n; j++) {
+		blockNum[j] = Input::getBlockNum(in.getTotalSize(j));
+		if (blockNum[j] > maxBlockNum) maxBlockNum = blockNum[j];
+	}
+	for (size_t b = 0; b < maxBlockNum; b++) {
+		V w[16] = {};
+		for (size_t j = 0; j < n; j++) {
+			if (b >= blockNum[j]) continue;
+			uint8_t blk[blockSize];
+			in.getBlock(blk, j, b);
+			for (int i = 0; i < 16; i++) {
+				w[i][j] = cybozu::Get32bitAsBE(blk + i * 4);
+			}
+		}
+		compress(h, w);
+		for (size_t j = 0; j < n; j++) {
+			if (b + 1 != blockNum[j]) continue;
+			for (int i = 0; i < 8; i++) {
+				cybozu::Set32bitAsBE(md + j * mdSize + i * 4, h[i][j]);
+			}
+		}
+	}
+}
+
+static const size_t laneNumAVX2 = 8;
+static const size_t laneNumAVX512 = 16;
+
+__attribute__((target("avx2")))
+inline void hashAVX2(uint8_t *md, const Input& in, size_t n)
+{
+	hashN<Vec8, laneNumAVX2>(md, in, n);
+}
+
+__attribute__((target("avx512f")))
+inline void hashAVX512(uint8_t *md, const Input& in, size_t n)
+{
+	hashN<Vec16, laneNumAVX512>(md, in, n);
+}
+
+#undef MCL_SHA256_MB_ROTR
+#undef MCL_SHA256_MB_INLINE
+
+#endif
+
+} } // mcl::sha256_mb
@@ -0,0 +1,79 @@
+#pragma once
+/**
+	@file
+	@brief SHA-256 by SHA extensions of x86
+	@license modified new BSD license
+	http://opensource.org/licenses/BSD-3-Clause
+	it is compiled by the target attribute
+	the caller must check the CPU before calling blockFunc
+*/
+#include <stdint.h>
+#include <stddef.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (CYBOZU_HOST == CYBOZU_HOST_INTEL) && (CYBOZU_OS_BIT == 64)
+	#define MCL_SHA256_NI
+
+#include <immintrin.h>
+
+namespace mcl { namespace sha256_ni {
+
+/*
+	the same interface as cybozu::sha2_local::Sha256BlockFunc
+	update h by n blocks of buf (64 * n bytes)
+*/
+__attribute__((target("sha,sse4.1")))
+inline void blockFunc(uint32_t h[8], const uint8_t *buf, size_t n)
+{
+	static const uint32_t kTbl[] = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+	};
+	// big endian to little endian of each 32-bit word
+	const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	/*
+		the instructions use (a, b, e, f) and (c, d, g, h)
+		h[0..3] = (a, b, c, d), h[4..7] = (e, f, g, h)
+	*/
+	__m128i t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&h[0]), 0xb1); // (c, d, a, b)
+	__m128i cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&h[4]), 0x1b); // (h, g, f, e)
+	__m128i abef = _mm_alignr_epi8(t, cdgh, 8);
+	cdgh = _mm_blend_epi16(cdgh, t, 0xf0);
+	for (size_t b = 0; b < n; b++) {
+		const __m128i abefSave = abef;
+		const __m128i cdghSave = cdgh;
+		// w[j] = W[4i..4i+3] for j = i % 4
+		__m128i w[4];
+		for (int i = 0; i < 4; i++) {
+			w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(buf + 16 * i)), bswap);
+		}
+		for (int i = 0; i < 16; i++) {
+			if (i >= 4) {
+				__m128i& x = w[i & 3];
+				x = _mm_sha256msg1_epu32(x, w[(i - 3) & 3]);
+				x = _mm_add_epi32(x, _mm_alignr_epi8(w[(i - 1) & 3], w[(i - 2) & 3], 4));
+				x = _mm_sha256msg2_epu32(x, w[(i - 1) & 3]);
+			}
+			__m128i wk = _mm_add_epi32(w[i & 3], _mm_loadu_si128((const __m128i*)&kTbl[i * 4]));
+			cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+			wk = _mm_shuffle_epi32(wk, 0x0e);
+			abef = _mm_sha256rnds2_epu32(abef, cdgh, wk);
+		}
+		abef = _mm_add_epi32(abef, abefSave);
+		cdgh = _mm_add_epi32(cdgh, cdghSave);
+		buf += 64;
+	}
+	t = _mm_shuffle_epi32(abef, 0x1b); // (f, e, b, a)
+	cdgh = _mm_shuffle_epi32(cdgh, 0xb1); // (d, c, h, g)
+	_mm_storeu_si128((__m128i*)&h[0], _mm_blend_epi16(t, cdgh, 0xf0));
+	_mm_storeu_si128((__m128i*)&h[4], _mm_alignr_epi8(cdgh, t, 8));
+}
+
+} } // mcl::sha256_ni
+
+#endif
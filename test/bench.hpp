@@ -177,11 +177,15 @@ void testBench(const G1& P, const G2& Q)
 	CYBOZU_BENCH_C("pairing       ", 3000, pairing, e1, P, Q);
 	CYBOZU_BENCH_C("millerLoop    ", 3000, millerLoop, e1, P, Q);
 	CYBOZU_BENCH_C("finalExp      ", 3000, finalExp, e1, e1);
+	CYBOZU_BENCH_C("isValidOrderGT", 3000, isValidOrderGT, e1);
 //exit(1);
 	std::vector<Fp6> Qcoeff;
 	CYBOZU_BENCH_C("precomputeG2  ", C, precomputeG2, Qcoeff, Q);
 	precomputeG2(Qcoeff, Q);
 	CYBOZU_BENCH_C("precomputedML ", C, precomputedMillerLoop, e2, P, Qcoeff);
+	std::vector<Fp2> Qcoeff2;
+	CYBOZU_BENCH_C("precomputeG2Affine", C, precomputeG2Affine, Qcoeff2, Q);
+	CYBOZU_BENCH_C("precomputedMLAffine", C, precomputedMillerLoopAffine, e2, P, Qcoeff2);
 	const size_t n = 7;
 	G1 Pvec[n];
 	G2 Qvec[n];
@@ -197,6 +201,15 @@ void testBench(const G1& P, const G2& Q)
 	}
 	CYBOZU_BENCH_C("millerLoopVec ", 3000, millerLoopVec, e1, Pvec, Qvec, n);
 	CYBOZU_TEST_EQUAL(e1, e2);
+	CYBOZU_BENCH_C("millerLoopVecAffine", 3000, millerLoopVecAffine, e1, Pvec, Qvec, n, true);
+	finalExp(e1, e1);
+	finalExp(e2, e2);
+	CYBOZU_TEST_EQUAL(e1, e2);
+	Fp12 fVec[n], gVec[n];
+	for (size_t i = 0; i < n; i++) {
+		millerLoop(fVec[i], Pvec[i], Qvec[i]);
+	}
+	CYBOZU_BENCH_C("finalExpVec   ", 300, finalExpVec, gVec, fVec, n);
 }
 
 inline void SquareRootPrecomputeTest(const mpz_class& p)
@@ -438,6 +438,88 @@ const char *e1Str =
 	CYBOZU_BENCH_C("finalExp", 100, finalExp, e2, e0);
 }
 
+/*
+	expHardPartBLS12 uses the decomposition of Hayashida, Hayasaka and Teruya
+	3 (p^4 - p^2 + 1)/r = (z-1)^2 (z+p)(z^2+p^2-1)+3
+	compare it with x^(c0 + c1 p + c2 p^2 + c3 p^3) of Aranha et al.
+*/
+CYBOZU_TEST_AUTO(expHardPartBLS12)
+{
+	initPairing(mcl::BLS12_381);
+	const mpz_class& z = BN::param.z;
+	const mpz_class z2 = z * z;
+	const mpz_class z3 = z2 * z;
+	const mpz_class z4 = z3 * z;
+	const mpz_class cTbl[4] = {
+		z4 * z - 2 * z4 + 2 * z2 - z + 3,
+		z4 - 2 * z3 + 2 * z - 1,
+		z3 - 2 * z2 + z,
+		z2 - 2 * z + 1,
+	};
+	cybozu::XorShift rg;
+	Fp12 x, y1, y2;
+	for (int i = 0; i < 5; i++) {
+		for (int j = 0; j < 12; j++) {
+			x.getFp0()[j].setByCSPRNG(rg);
+		}
+		local::mapToCyclotomic(x, x);
+		local::expHardPartBLS12(y1, x);
+		y2 = 1;
+		for (int j = 3; j >= 0; j--) {
+			Fp12 t;
+			Fp12::Frobenius(y2, y2);
+			Fp12::powGeneric(t, x, cTbl[j] < 0 ? -cTbl[j] : cTbl[j]);
+			if (cTbl[j] < 0) Fp12::unitaryInv(t, t);
+			y2 *= t;
+		}
+		CYBOZU_TEST_EQUAL(y1, y2);
+	}
+#ifndef NDEBUG
+	puts("skip bench of expHardPartBLS12 in debug");
+	return;
+#endif
+	CYBOZU_BENCH_C("expHardPartBLS12", 100, local::expHardPartBLS12, y1, x);
+	CYBOZU_BENCH_C("pow_z", 100, local::pow_z, y1, x);
+}
+
+CYBOZU_TEST_AUTO(powSparse)
+{
+	initPairing(mcl::BLS12_381);
+	cybozu::XorShift rg;
+	Fp12 x, y1, y2;
+	for (int j = 0; j < 12; j++) {
+		x.getFp0()[j].setByCSPRNG(rg);
+	}
+	local::mapToCyclotomic(x, x);
+	// z = -(2^63 + 2^62 + 2^60 + 2^57 + 2^48 + 2^16)
+	local::pow_z(y1, x);
+	Fp12::powGeneric(y2, x, BN::param.abs_z);
+	Fp12::unitaryInv(y2, y2);
+	CYBOZU_TEST_EQUAL(y1, y2);
+	CYBOZU_TEST_ASSERT(local::Compress::powSparse(y1, x, BN::param.zReplTbl));
+	Fp12::powGeneric(y2, x, BN::param.abs_z);
+	CYBOZU_TEST_EQUAL(y1, y2);
+	// aliasing and negative digits ; e = 2^20 - 2^9 + 1
+	local::SignVec naf;
+	naf.resize(21);
+	for (size_t i = 0; i < naf.size(); i++) naf[i] = 0;
+	naf[0] = 1;
+	naf[20 - 9] = -1;
+	naf[20] = 1;
+	y1 = x;
+	CYBOZU_TEST_ASSERT(local::Compress::powSparse(y1, y1, naf));
+	Fp12::powGeneric(y2, x, mpz_class((1 << 20) - (1 << 9) + 1));
+	CYBOZU_TEST_EQUAL(y1, y2);
+	// too many nonzero digits
+	for (size_t i = 0; i < naf.size(); i++) naf[i] = 1;
+	y1 = x;
+	CYBOZU_TEST_ASSERT(!local::Compress::powSparse(y1, x, naf));
+	CYBOZU_TEST_EQUAL(y1, x);
+	x = 1;
+	CYBOZU_TEST_ASSERT(local::Compress::powSparse(y1, x, BN::param.zReplTbl));
+	CYBOZU_TEST_ASSERT(y1.isOne());
+}
+
 #if 0 // test for only Proj
 CYBOZU_TEST_AUTO(addLine)
 {
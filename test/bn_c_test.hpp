@@ -455,6 +455,288 @@ CYBOZU_TEST_AUTO(millerLoopVec)
 	CYBOZU_TEST_ASSERT(mclBnGT_isEqual(&e1, &e2));
 }
 
+CYBOZU_TEST_AUTO(serializeCompressedGT)
+{
+	const size_t n = 3;
+	mclBnG1 P;
+	mclBnG2 Q;
+	mclBnG1_hashAndMapTo(&P, "abc", 3);
+	mclBnG2_hashAndMapTo(&Q, "abc", 3);
+	mclBnGT xVec[n], yVec[n];
+	mclBn_pairing(&xVec[0], &P, &Q);
+	mclBnGT_sqr(&xVec[1], &xVec[0]);
+	mclBnGT_setInt(&xVec[2], 1);
+	char buf[1024];
+	const mclSize size = mclBnGT_serialize(buf, sizeof(buf), &xVec[0]);
+	CYBOZU_TEST_ASSERT(size > 0);
+	mclSize pos = 0;
+	for (size_t i = 0; i < n; i++) {
+		const mclSize cSize = mclBnGT_serializeCompressed(buf + pos, sizeof(buf) - pos, &xVec[i]);
+		CYBOZU_TEST_EQUAL(cSize * 2, size);
+		CYBOZU_TEST_EQUAL(mclBnGT_deserializeCompressed(&yVec[i], buf + pos, cSize), cSize);
+		CYBOZU_TEST_ASSERT(mclBnGT_isEqual(&xVec[i], &yVec[i]));
+		pos += cSize;
+	}
+	memset(yVec, 0, sizeof(yVec));
+	CYBOZU_TEST_EQUAL(mclBnGT_deserializeCompressedVec(yVec, buf, pos, n), pos);
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_ASSERT(mclBnGT_isEqual(&xVec[i], &yVec[i]));
+	}
+}
+
+CYBOZU_TEST_AUTO(GTisValidOrder)
+{
+	mclBnG1 P;
+	mclBnG2 Q;
+	mclBnG1_hashAndMapTo(&P, "abc", 3);
+	mclBnG2_hashAndMapTo(&Q, "abc", 3);
+	mclBnGT e, x;
+	mclBn_pairing(&e, &P, &Q);
+	CYBOZU_TEST_ASSERT(mclBnGT_isValidOrder(&e));
+	mclBn_millerLoop(&x, &P, &Q);
+	CYBOZU_TEST_ASSERT(!mclBnGT_isValidOrder(&x));
+	char buf1[1024], buf2[1024];
+	const mclSize n = mclBnGT_serialize(buf1, sizeof(buf1), &e);
+	CYBOZU_TEST_ASSERT(n > 0);
+	CYBOZU_TEST_EQUAL(mclBnGT_serialize(buf2, sizeof(buf2), &x), n);
+	mclBn_verifyOrderGT(1);
+	mclBnGT y;
+	CYBOZU_TEST_EQUAL(mclBnGT_deserialize(&y, buf1, n), n);
+	CYBOZU_TEST_ASSERT(mclBnGT_isEqual(&y, &e));
+	CYBOZU_TEST_EQUAL(mclBnGT_deserialize(&y, buf2, n), 0u);
+	mclBn_verifyOrderGT(0);
+	CYBOZU_TEST_EQUAL(mclBnGT_deserialize(&y, buf2, n), n);
+	// compressed
+	const mclSize cSize = mclBnGT_serializeCompressed(buf1, sizeof(buf1), &e);
+	CYBOZU_TEST_ASSERT(cSize > 0);
+	CYBOZU_TEST_EQUAL(mclBnGT_serializeCompressed(buf1 + cSize, sizeof(buf1) - cSize, &x), cSize);
+	mclBn_verifyOrderGT(1);
+	CYBOZU_TEST_EQUAL(mclBnGT_deserializeCompressed(&y, buf1, cSize), cSize);
+	CYBOZU_TEST_ASSERT(mclBnGT_isEqual(&y, &e));
+	CYBOZU_TEST_EQUAL(mclBnGT_deserializeCompressed(&y, buf1 + cSize, cSize), 0u);
+	mclBnGT yVec[2];
+	CYBOZU_TEST_EQUAL(mclBnGT_deserializeCompressedVec(yVec, buf1, cSize * 2, 2), 0u);
+	mclBn_verifyOrderGT(0);
+	CYBOZU_TEST_EQUAL(mclBnGT_deserializeCompressed(&y, buf1 + cSize, cSize), cSize);
+	CYBOZU_TEST_EQUAL(mclBnGT_deserializeCompressedVec(yVec, buf1, cSize * 2, 2), cSize * 2);
+}
+
+CYBOZU_TEST_AUTO(finalExpVec)
+{
+	const size_t n = 5;
+	mclBnGT xVec[n], yVec[n];
+	for (size_t i = 0; i < n; i++) {
+		char d = (char)(i + 1);
+		mclBnG1 P;
+		mclBnG2 Q;
+		mclBnG1_hashAndMapTo(&P, &d, 1);
+		mclBnG2_hashAndMapTo(&Q, &d, 1);
+		mclBn_millerLoop(&xVec[i], &P, &Q);
+	}
+	mclBn_finalExpVec(yVec, xVec, n);
+	for (size_t i = 0; i < n; i++) {
+		mclBnGT e;
+		mclBn_finalExp(&e, &xVec[i]);
+		CYBOZU_TEST_ASSERT(mclBnGT_isEqual(&e, &yVec[i]));
+	}
+	mclBn_finalExpVecMT(xVec, xVec, n, 0);
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_ASSERT(mclBnGT_isEqual(&xVec[i], &yVec[i]));
+	}
+}
+
+CYBOZU_TEST_AUTO(precomputedMillerLoopVec)
+{
+	const size_t n = 7;
+	const size_t qN = mclBn_getUint64NumToPrecompute();
+	mclBnG1 Pvec[n];
+	mclBnG2 Qvec[n];
+	std::vector<uint64_t> QbufVec(n * qN);
+	for (size_t i = 0; i < n; i++) {
+		char d = (char)(i + 1);
+		mclBnG1_hashAndMapTo(&Pvec[i], &d, 1);
+		mclBnG2_hashAndMapTo(&Qvec[i], &d, 1);
+		mclBn_precomputeG2(&QbufVec[i * qN], &Qvec[i]);
+	}
+	mclBnGT e1, e2;
+	mclBn_millerLoopVec(&e1, Pvec, Qvec, n);
+	mclBn_precomputedMillerLoopVec(&e2, Pvec, QbufVec.data(), n);
+	CYBOZU_TEST_ASSERT(mclBnGT_isEqual(&e1, &e2));
+	mclBn_precomputedMillerLoopVecMixed(&e2, Pvec, Qvec, 3, Pvec + 3, &QbufVec[3 * qN], n - 3);
+	CYBOZU_TEST_ASSERT(mclBnGT_isEqual(&e1, &e2));
+}
+
+CYBOZU_TEST_AUTO(precomputedMillerLoopAffine)
+{
+	const size_t n = 7;
+	const size_t qN = mclBn_getUint64NumToPrecomputeAffine();
+	CYBOZU_TEST_EQUAL(qN * 3, mclBn_getUint64NumToPrecompute() * 2u);
+	mclBnG1 Pvec[n];
+	mclBnG2 Qvec[n];
+	std::vector<uint64_t> QbufVec(n * qN);
+	for (size_t i = 0; i < n; i++) {
+		char d = (char)(i + 1);
+		mclBnG1_hashAndMapTo(&Pvec[i], &d, 1);
+		mclBnG2_hashAndMapTo(&Qvec[i], &d, 1);
+		mclBn_precomputeG2Affine(&QbufVec[i * qN], &Qvec[i]);
+	}
+	mclBnGT e1, e2;
+	mclBn_pairing(&e1, &Pvec[0], &Qvec[0]);
+	mclBn_precomputedMillerLoopAffine(&e2, &Pvec[0], &QbufVec[0]);
+	mclBn_finalExp(&e2, &e2);
+	CYBOZU_TEST_ASSERT(mclBnGT_isEqual(&e1, &e2));
+	mclBn_millerLoopVec(&e1, Pvec, Qvec, n);
+	mclBn_finalExp(&e1, &e1);
+	mclBn_precomputedMillerLoopAffineVec(&e2, Pvec, QbufVec.data(), n);
+	mclBn_finalExp(&e2, &e2);
+	CYBOZU_TEST_ASSERT(mclBnGT_isEqual(&e1, &e2));
+}
+
+CYBOZU_TEST_AUTO(hashAndMapToG1Vec)
+{
+	const size_t n = 20;
+	char msg[n][2];
+	const void *bufVec[n];
+	mclSize bufSizeVec[n];
+	mclBnG1 Pvec1[n], Pvec2[n];
+	for (size_t i = 0; i < n; i++) {
+		msg[i][0] = 'm';
+		msg[i][1] = (char)('a' + i);
+		bufVec[i] = msg[i];
+		bufSizeVec[i] = (mclSize)(i % 2 + 1);
+		CYBOZU_TEST_ASSERT(!mclBnG1_hashAndMapTo(&Pvec1[i], bufVec[i], bufSizeVec[i]));
+	}
+	CYBOZU_TEST_ASSERT(!mclBnG1_hashAndMapToVec(Pvec2, bufVec, bufSizeVec, n));
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_ASSERT(mclBnG1_isEqual(&Pvec1[i], &Pvec2[i]));
+	}
+	CYBOZU_TEST_ASSERT(!mclBnG1_hashAndMapToVecMT(Pvec2, bufVec, bufSizeVec, n, 0));
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_ASSERT(mclBnG1_isEqual(&Pvec1[i], &Pvec2[i]));
+	}
+}
+
+CYBOZU_TEST_AUTO(hashAndMapToG2Vec)
+{
+	const size_t n = 20;
+	char msg[n][2];
+	const void *bufVec[n];
+	mclSize bufSizeVec[n];
+	mclBnG2 Qvec1[n], Qvec2[n];
+	for (size_t i = 0; i < n; i++) {
+		msg[i][0] = 'm';
+		msg[i][1] = (char)('a' + i);
+		bufVec[i] = msg[i];
+		bufSizeVec[i] = (mclSize)(i % 2 + 1);
+		CYBOZU_TEST_ASSERT(!mclBnG2_hashAndMapTo(&Qvec1[i], bufVec[i], bufSizeVec[i]));
+	}
+	CYBOZU_TEST_ASSERT(!mclBnG2_hashAndMapToVec(Qvec2, bufVec, bufSizeVec, n));
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_ASSERT(mclBnG2_isEqual(&Qvec1[i], &Qvec2[i]));
+	}
+	CYBOZU_TEST_ASSERT(!mclBnG2_hashAndMapToVecMT(Qvec2, bufVec, bufSizeVec, n, 0));
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_ASSERT(mclBnG2_isEqual(&Qvec1[i], &Qvec2[i]));
+	}
+}
+
+CYBOZU_TEST_AUTO(G2Cache)
+{
+	const size_t n = 3;
+	mclBnG1 P;
+	mclBnG1_hashAndMapTo(&P, "abc", 3);
+	mclBnG2 Qvec[n];
+	char buf[n][256];
+	mclSize bufSize[n];
+	for (size_t i = 0; i < n; i++) {
+		char d = (char)(i + 1);
+		mclBnG2_hashAndMapTo(&Qvec[i], &d, 1);
+		bufSize[i] = mclBnG2_serialize(buf[i], sizeof(buf[i]), &Qvec[i]);
+		CYBOZU_TEST_ASSERT(bufSize[i] > 0);
+	}
+	if (mclBn_setG2CacheMaxByte(1024 * 1024) != 0) return;
+	mclBn_clearG2Cache();
+	for (int j = 0; j < 2; j++) {
+		for (size_t i = 0; i < n; i++) {
+			mclBnG2 Q;
+			CYBOZU_TEST_EQUAL(mclBnG2_deserialize(&Q, buf[i], bufSize[i]), bufSize[i]);
+			CYBOZU_TEST_ASSERT(mclBnG2_isEqual(&Q, &Qvec[i]));
+			mclBnGT e1, e2;
+			mclBn_millerLoop(&e1, &P, &Qvec[i]);
+			CYBOZU_TEST_EQUAL(mclBn_millerLoopCachedG2(&e2, &P, buf[i], bufSize[i]), 0);
+			CYBOZU_TEST_ASSERT(mclBnGT_isEqual(&e1, &e2));
+		}
+	}
+	uint64_t hitNum, missNum;
+	mclSize byteSize;
+	mclBn_getG2CacheStat(&hitNum, &missNum, &byteSize);
+	// a deserialized entry is updated once by millerLoop
+	CYBOZU_TEST_EQUAL(missNum, n * 2);
+	CYBOZU_TEST_EQUAL(hitNum, n * 2);
+	CYBOZU_TEST_ASSERT(byteSize > 0);
+	// the cached points are not used after the serialization mode is changed
+	{
+		const int eth = mclBn_getETHserialization();
+		mclBnG2 Qvec2[n];
+		mclSize sizeVec2[n];
+		mclBn_setG2CacheMaxByte(0);
+		mclBn_setETHserialization(!eth);
+		for (size_t i = 0; i < n; i++) {
+			sizeVec2[i] = mclBnG2_deserialize(&Qvec2[i], buf[i], bufSize[i]);
+		}
+		mclBn_setETHserialization(eth);
+		mclBn_setG2CacheMaxByte(1024 * 1024);
+		for (size_t i = 0; i < n; i++) {
+			mclBnG2 Q;
+			CYBOZU_TEST_EQUAL(mclBnG2_deserialize(&Q, buf[i], bufSize[i]), bufSize[i]);
+		}
+		mclBn_setETHserialization(!eth);
+		for (size_t i = 0; i < n; i++) {
+			mclBnG2 Q;
+			CYBOZU_TEST_EQUAL(mclBnG2_deserialize(&Q, buf[i], bufSize[i]), sizeVec2[i]);
+			if (sizeVec2[i] > 0) CYBOZU_TEST_ASSERT(mclBnG2_isEqual(&Q, &Qvec2[i]));
+		}
+		mclBn_setETHserialization(eth);
+	}
+	buf[0][bufSize[0] / 2] ^= 1;
+	mclBnGT e;
+	CYBOZU_TEST_EQUAL(mclBn_millerLoopCachedG2(&e, &P, buf[0], bufSize[0]), -1);
+	mclBn_setG2CacheMaxByte(0);
+	mclBn_getG2CacheStat(&hitNum, &missNum, &byteSize);
+	CYBOZU_TEST_EQUAL(byteSize, 0u);
+}
+
+CYBOZU_TEST_AUTO(verifyPairingEquations)
+{
+	// e(x H_i, Q) e(-H_i, x Q) == 1
+	const size_t k = 5;
+	mclBnG1 Pvec[k * 2];
+	mclBnG2 Qvec[k * 2];
+	mclSize nVec[k];
+	mclBnG2 Q;
+	mclBnG2_hashAndMapTo(&Q, "abc", 3);
+	for (size_t i = 0; i < k; i++) {
+		char d = (char)(i + 1);
+		mclBnFr x;
+		mclBnFr_setInt(&x, (int)i + 100);
+		mclBnG1 H;
+		mclBnG1_hashAndMapTo(&H, &d, 1);
+		mclBnG1_mul(&Pvec[i * 2], &H, &x);
+		Qvec[i * 2] = Q;
+		mclBnG1_neg(&Pvec[i * 2 + 1], &H);
+		mclBnG2_mul(&Qvec[i * 2 + 1], &Q, &x);
+		nVec[i] = 2;
+	}
+	int okVec[k];
+	CYBOZU_TEST_EQUAL(mclBn_verifyPairingEquations(okVec, Pvec, Qvec, nVec, k), 1);
+	CYBOZU_TEST_EQUAL(mclBn_verifyPairingEquations(NULL, Pvec, Qvec, nVec, k), 1);
+	mclBnG1_dbl(&Pvec[4], &Pvec[4]);
+	CYBOZU_TEST_EQUAL(mclBn_verifyPairingEquations(okVec, Pvec, Qvec, nVec, k), 0);
+	for (size_t i = 0; i < k; i++) {
+		CYBOZU_TEST_EQUAL(okVec[i], i != 2);
+	}
+}
+
 CYBOZU_TEST_AUTO(millerLoopVecMT)
 {
 	const size_t n = 10;
@@ -1052,6 +1334,26 @@ CYBOZU_TEST_AUTO(getLittleEndian)
 	}
 }
 
+struct MulVecStreamReader {
+	const mclBnG1 *x;
+	const mclBnFr *y;
+	size_t n;
+	size_t pos;
+};
+
+mclSize readForMulVecStream(mclBnG1 *x, mclBnFr *y, mclSize maxN, void *self)
+{
+	MulVecStreamReader *r = (MulVecStreamReader*)self;
+	size_t n = r->n - r->pos;
+	if (n > maxN) n = maxN;
+	for (size_t i = 0; i < n; i++) {
+		x[i] = r->x[r->pos + i];
+		y[i] = r->y[r->pos + i];
+	}
+	r->pos += n;
+	return n;
+}
+
 CYBOZU_TEST_AUTO(mulVec)
 {
 	const size_t N = 70;
@@ -1088,6 +1390,10 @@ CYBOZU_TEST_AUTO(mulVec)
 	CYBOZU_TEST_ASSERT(mclBnG1_isEqual(&z1, &w1));
 	CYBOZU_TEST_ASSERT(mclBnG2_isEqual(&z2, &w2));
 	CYBOZU_TEST_ASSERT(mclBnGT_isEqual(&zt, &wt));
+
+	MulVecStreamReader r = { x1Vec, yVec, N, 0 };
+	CYBOZU_TEST_EQUAL(mclBnG1_mulVecStream(&z1, readForMulVecStream, &r, N), 0);
+	CYBOZU_TEST_ASSERT(mclBnG1_isEqual(&z1, &w1));
 }
 
 void G1onlyTest(int curve)
@@ -196,6 +196,8 @@ void testCompress(const G1& P, const G2& Q)
 	Fp12 c;
 	Fp12::pow(c, a, BN::param.abs_z);
 	CYBOZU_TEST_EQUAL(b, c);
+	CYBOZU_TEST_ASSERT(Compress::powSparse(b, a, BN::param.zReplTbl));
+	CYBOZU_TEST_EQUAL(b, c);
 }
 
 void testPrecomputed(const G1& P, const G2& Q)
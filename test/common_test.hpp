@@ -28,6 +28,7 @@ void testMulVec(const G& P)
 	const int N = 4096;
 	std::vector<G> x0Vec(N);
 	std::vector<G> xVec(N);
+	std::vector<G> nVec(N);
 	std::vector<Fr> yVec(N);
 
 	cybozu::XorShift rg;
@@ -36,6 +37,8 @@ void testMulVec(const G& P)
 		xVec[i] = x0Vec[i];
 		yVec[i].setByCSPRNG(rg);
 	}
+	G::normalizeVec(nVec.data(), x0Vec.data(), N);
+	const G *cx0Vec = x0Vec.data();
 	const size_t nTbl[] = { 1, 2, 3, 15, 16, 17, 32, 64, 128, 256,
 #if 0
 		512, 1024, 2048, N
@@ -48,6 +51,10 @@ void testMulVec(const G& P)
 		naiveMulVec(Q1, xVec.data(), yVec.data(), n);
 		G::mulVec(Q2, xVec.data(), yVec.data(), n);
 		CYBOZU_TEST_EQUAL(Q1, Q2);
+		G::mulVec(Q2, cx0Vec, yVec.data(), n, false);
+		CYBOZU_TEST_EQUAL(Q1, Q2);
+		G::mulVec(Q2, nVec.data(), yVec.data(), n, true);
+		CYBOZU_TEST_EQUAL(Q1, Q2);
 		Q2.clear();
 #if 0 // #ifdef NDEBUG
 		printf("n=%zd\n", n);
@@ -233,8 +240,459 @@ void testMulSmall()
 	}
 }
 
+// same as the default hash but not regarded as the default one
+uint32_t customHash(void *out, uint32_t maxOutSize, const void *msg, uint32_t msgSize)
+{
+	return mcl::fp::sha256(out, maxOutSize, msg, msgSize);
+}
+
+void testHashAndMapToStream()
+{
+	puts("testHashAndMapToStream");
+	std::string msg(1000, 0);
+	for (size_t i = 0; i < msg.size(); i++) {
+		msg[i] = char(i * 3 + 1);
+	}
+	const int curMode = getMapToMode();
+	const int modeTbl[] = {
+		MCL_MAP_TO_MODE_ORIGINAL,
+		MCL_MAP_TO_MODE_TRY_AND_INC,
+		MCL_MAP_TO_MODE_HASH_TO_CURVE_07,
+	};
+	const size_t chunkTbl[] = { 1, 63, 64, 65, 333, 1000 };
+	const char *dst = "QUUX-V01-CS02-with-BLS12381G2_XMD:SHA-256_SSWU_RO_";
+	const size_t dstSize = strlen(dst);
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(modeTbl); i++) {
+		const int mode = modeTbl[i];
+		if (mode == MCL_MAP_TO_MODE_HASH_TO_CURVE_07 && !BN::param.isBLS12) continue;
+		CYBOZU_TEST_ASSERT(setMapToMode(mode));
+		G1 P1, P2;
+		G2 Q1, Q2;
+		Fr x1, x2;
+		for (size_t j = 0; j < CYBOZU_NUM_OF_ARRAY(chunkTbl); j++) {
+			const size_t chunk = chunkTbl[j];
+			for (size_t n = 0; n <= msg.size(); n += 250) {
+				HashAndMapToStream hs;
+				SetHashOfStream<Fr> fs;
+				for (size_t pos = 0; pos < n; pos += chunk) {
+					const size_t size = std::min(chunk, n - pos);
+					hs.update(&msg[pos], size);
+					fs.update(&msg[pos], size);
+				}
+				hashAndMapToG1(P1, msg.data(), n);
+				hs.finalizeToG1(P2);
+				CYBOZU_TEST_EQUAL(P1, P2);
+				x1.setHashOf(msg.data(), n);
+				fs.finalize(x2);
+				CYBOZU_TEST_EQUAL(x1, x2);
+				hs.clear();
+				hs.update(msg.data(), n);
+				hashAndMapToG2(Q1, msg.data(), n);
+				hs.finalizeToG2(Q2);
+				CYBOZU_TEST_EQUAL(Q1, Q2);
+				if (!BN::param.isBLS12) continue;
+				hs.clear();
+				hs.update(msg.data(), n);
+				hashAndMapToG1(P1, msg.data(), n, dst, dstSize);
+				hs.finalizeToG1(P2, dst, dstSize);
+				CYBOZU_TEST_EQUAL(P1, P2);
+				hs.clear();
+				hs.update(msg.data(), n);
+				hashAndMapToG2(Q1, msg.data(), n, dst, dstSize);
+				hs.finalizeToG2(Q2, dst, dstSize);
+				CYBOZU_TEST_EQUAL(Q1, Q2);
+			}
+		}
+	}
+	// finalize fails if the hash function is changed
+	{
+		uint32_t (*hash)(void *, uint32_t, const void *, uint32_t) = Fr::getOp().hash;
+		Fr::setHashFunc(customHash);
+		SetHashOfStream<Fr> fs;
+		fs.update(msg.data(), msg.size());
+		Fr x;
+		bool b;
+		fs.finalize(&b, x);
+		CYBOZU_TEST_ASSERT(!b);
+		CYBOZU_TEST_EXCEPTION(fs.finalize(x), cybozu::Exception);
+		Fr::setHashFunc(hash);
+		fs.clear();
+		fs.update(msg.data(), msg.size());
+		fs.finalize(&b, x);
+		CYBOZU_TEST_ASSERT(b);
+		Fr x2;
+		x2.setHashOf(msg.data(), msg.size());
+		CYBOZU_TEST_EQUAL(x, x2);
+	}
+	{
+		CYBOZU_TEST_ASSERT(setMapToMode(MCL_MAP_TO_MODE_ORIGINAL));
+		uint32_t (*hash)(void *, uint32_t, const void *, uint32_t) = Fp::getOp().hash;
+		Fp::setHashFunc(customHash);
+		HashAndMapToStream hs;
+		hs.update(msg.data(), msg.size());
+		G1 P;
+		G2 Q;
+		bool b;
+		hs.finalizeToG1(&b, P);
+		CYBOZU_TEST_ASSERT(!b);
+		CYBOZU_TEST_EXCEPTION(hs.finalizeToG2(Q), cybozu::Exception);
+		Fp::setHashFunc(hash);
+	}
+	setMapToMode(curMode);
+}
+
+void testMillerLoopVecAffine()
+{
+	puts("testMillerLoopVecAffine");
+	const size_t n = 70;
+	G1 Pvec[n];
+	G2 Qvec[n];
+	char c = 'a';
+	for (size_t i = 0; i < n; i++) {
+		hashAndMapToG1(Pvec[i], &c, 1);
+		hashAndMapToG2(Qvec[i], &c, 1);
+		c++;
+	}
+	// zero elements are skipped
+	Pvec[3].clear();
+	Qvec[40].clear();
+	const size_t mTbl[] = { 0, 1, 2, 3, 31, 32, 33, 64, n };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(mTbl); i++) {
+		const size_t m = mTbl[i];
+		Fp12 f1, f2;
+		millerLoopVec(f1, Pvec, Qvec, m);
+		millerLoopVecAffine(f2, Pvec, Qvec, m);
+		finalExp(f1, f1);
+		finalExp(f2, f2);
+		CYBOZU_TEST_EQUAL(f1, f2);
+		// initF = false
+		Fp12 e1, e2;
+		millerLoop(e1, Pvec[0], Qvec[1]);
+		pairing(e2, Pvec[0], Qvec[1]);
+		f2 = e1;
+		millerLoopVecAffine(f2, Pvec, Qvec, m, false);
+		finalExp(f2, f2);
+		CYBOZU_TEST_EQUAL(f2, f1 * e2);
+	}
+}
+
+void testPrecomputedMillerLoopVec()
+{
+	puts("testPrecomputedMillerLoopVec");
+	const size_t n = 90;
+	const size_t qN = BN::param.precomputedQcoeffSize;
+	G1 Pvec[n];
+	G2 Qvec[n];
+	char c = 'a';
+	for (size_t i = 0; i < n; i++) {
+		hashAndMapToG1(Pvec[i], &c, 1);
+		hashAndMapToG2(Qvec[i], &c, 1);
+		c++;
+	}
+	// zero elements are skipped
+	Pvec[3].clear();
+	Qvec[5].clear();
+	std::vector<Fp6> QcoeffVec(n * qN);
+	for (size_t i = 0; i < n; i++) {
+		precomputeG2(&QcoeffVec[i * qN], Qvec[i]);
+	}
+	const size_t mTbl[] = { 0, 1, 2, 6, 16, 17, 64, 65, n };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(mTbl); i++) {
+		const size_t m = mTbl[i];
+		Fp12 f1, f2;
+		millerLoopVec(f1, Pvec, Qvec, m);
+		precomputedMillerLoopVec(f2, Pvec, QcoeffVec, m);
+		CYBOZU_TEST_EQUAL(f1, f2);
+		// initF = false
+		Fp12 e;
+		millerLoop(e, Pvec[0], Qvec[1]);
+		f2 = e;
+		precomputedMillerLoopVec(f2, Pvec, QcoeffVec, m, false);
+		CYBOZU_TEST_EQUAL(f2, f1 * e);
+		// the first m1 pairs are not precomputed
+		for (size_t m1 = 0; m1 <= m; m1 += 7) {
+			precomputedMillerLoopVecMixed(f2, Pvec, Qvec, m1, Pvec + m1, &QcoeffVec[m1 * qN], m - m1);
+			CYBOZU_TEST_EQUAL(f1, f2);
+		}
+	}
+}
+
+void testPrecomputedMillerLoopAffine()
+{
+	puts("testPrecomputedMillerLoopAffine");
+	const size_t n = 70;
+	const size_t qN = BN::param.precomputedQcoeffSize * 2;
+	G1 Pvec[n];
+	G2 Qvec[n];
+	char c = 'a';
+	for (size_t i = 0; i < n; i++) {
+		hashAndMapToG1(Pvec[i], &c, 1);
+		hashAndMapToG2(Qvec[i], &c, 1);
+		c++;
+	}
+	// zero elements are skipped
+	Pvec[3].clear();
+	Qvec[5].clear();
+	std::vector<Fp2> QcoeffVec(n * qN);
+	for (size_t i = 0; i < n; i++) {
+		precomputeG2Affine(&QcoeffVec[i * qN], Qvec[i]);
+	}
+	{
+		std::vector<Fp6> Qcoeff;
+		std::vector<Fp2> Qcoeff2;
+		precomputeG2(Qcoeff, Qvec[0]);
+		precomputeG2Affine(Qcoeff2, Qvec[0]);
+		CYBOZU_TEST_EQUAL(Qcoeff2.size() * sizeof(Fp2) * 3, Qcoeff.size() * sizeof(Fp6) * 2);
+		Fp12 f1, f2;
+		pairing(f1, Pvec[0], Qvec[0]);
+		precomputedMillerLoopAffine(f2, Pvec[0], Qcoeff2);
+		finalExp(f2, f2);
+		CYBOZU_TEST_EQUAL(f1, f2);
+		precomputedMillerLoopAffine(f2, Pvec[3], Qcoeff2);
+		CYBOZU_TEST_ASSERT(f2.isOne());
+		precomputedMillerLoopAffine(f2, Pvec[0], &QcoeffVec[5 * qN]);
+		CYBOZU_TEST_ASSERT(f2.isOne());
+	}
+	const size_t mTbl[] = { 0, 1, 2, 6, 64, 65, n };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(mTbl); i++) {
+		const size_t m = mTbl[i];
+		Fp12 f1, f2;
+		millerLoopVec(f1, Pvec, Qvec, m);
+		finalExp(f1, f1);
+		precomputedMillerLoopAffineVec(f2, Pvec, QcoeffVec, m);
+		finalExp(f2, f2);
+		CYBOZU_TEST_EQUAL(f1, f2);
+		// initF = false
+		Fp12 e;
+		millerLoop(e, Pvec[0], Qvec[1]);
+		f2 = e;
+		precomputedMillerLoopAffineVec(f2, Pvec, QcoeffVec, m, false);
+		finalExp(f2, f2);
+		finalExp(e, e);
+		CYBOZU_TEST_EQUAL(f2, f1 * e);
+	}
+}
+
+void testFinalExpVec()
+{
+	puts("testFinalExpVec");
+	const size_t n = 40;
+	Fp12 xVec[n], yVec[n], zVec[n];
+	char c = 'a';
+	for (size_t i = 0; i < n; i++) {
+		G1 P;
+		G2 Q;
+		hashAndMapToG1(P, &c, 1);
+		hashAndMapToG2(Q, &c, 1);
+		millerLoop(xVec[i], P, Q);
+		c++;
+	}
+	// zero and one are also converted
+	xVec[2].clear();
+	xVec[3] = 1;
+	for (size_t i = 0; i < n; i++) {
+		finalExp(zVec[i], xVec[i]);
+	}
+	const size_t mTbl[] = { 0, 1, 2, 15, 16, 17, n };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(mTbl); i++) {
+		const size_t m = mTbl[i];
+		finalExpVec(yVec, xVec, m);
+		for (size_t j = 0; j < m; j++) {
+			CYBOZU_TEST_EQUAL(yVec[j], zVec[j]);
+		}
+		for (size_t cpuN = 0; cpuN < 4; cpuN++) {
+			for (size_t j = 0; j < m; j++) yVec[j] = xVec[j];
+			finalExpVecMT(yVec, yVec, m, cpuN);
+			for (size_t j = 0; j < m; j++) {
+				CYBOZU_TEST_EQUAL(yVec[j], zVec[j]);
+			}
+		}
+	}
+}
+
+void testCompressedGT(const G1& P, const G2& Q)
+{
+	puts("testCompressedGT");
+	const size_t n = 70;
+	Fp12 xVec[n], yVec[n];
+	Fp6 cVec[n];
+	Fp12 e;
+	pairing(e, P, Q);
+	xVec[0] = 1;
+	for (size_t i = 1; i < n; i++) {
+		xVec[i] = xVec[i - 1] * e;
+	}
+	for (size_t i = 0; i < n; i++) {
+		Fp6 c;
+		compressGT(c, xVec[i]);
+		decompressGT(yVec[i], c);
+		CYBOZU_TEST_EQUAL(xVec[i], yVec[i]);
+	}
+	CYBOZU_TEST_ASSERT(yVec[0].isOne());
+	compressGTVec(cVec, xVec, n);
+	decompressGTVec(yVec, cVec, n);
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_EQUAL(xVec[i], yVec[i]);
+	}
+	const size_t cSize = Fp::getByteSize() * 6;
+	{
+		uint8_t xBuf[1024];
+		CYBOZU_TEST_EQUAL(e.serialize(xBuf, sizeof(xBuf)), cSize * 2);
+		CYBOZU_TEST_EQUAL(serializeCompressedGT(xBuf, cSize - 1, e), 0u);
+	}
+	std::vector<uint8_t> buf(cSize * n);
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_EQUAL(serializeCompressedGT(&buf[cSize * i], cSize, xVec[i]), cSize);
+		CYBOZU_TEST_EQUAL(deserializeCompressedGT(yVec[i], &buf[cSize * i], cSize), cSize);
+		CYBOZU_TEST_EQUAL(xVec[i], yVec[i]);
+	}
+	for (size_t i = 0; i < n; i++) yVec[i].clear();
+	CYBOZU_TEST_EQUAL(deserializeCompressedGTVec(yVec, buf.data(), buf.size(), n), buf.size());
+	for (size_t i = 0; i < n; i++) {
+		CYBOZU_TEST_EQUAL(xVec[i], yVec[i]);
+	}
+	CYBOZU_TEST_EQUAL(deserializeCompressedGTVec(yVec, buf.data(), buf.size() - 1, n), 0u);
+}
+
+void testIsValidOrderGT(const G1& P, const G2& Q)
+{
+	puts("testIsValidOrderGT");
+	GT e, x;
+	pairing(e, P, Q);
+	CYBOZU_TEST_ASSERT(e.isValidOrder());
+	x = 1;
+	CYBOZU_TEST_ASSERT(x.isValidOrder());
+	x.clear();
+	CYBOZU_TEST_ASSERT(!x.isValidOrder());
+	cybozu::XorShift rg;
+	for (int i = 0; i < 10; i++) {
+		GT::pow(x, e, i + 2);
+		CYBOZU_TEST_ASSERT(x.isValidOrder());
+		for (int j = 0; j < 12; j++) {
+			x.getFp0()[j].setByCSPRNG(rg);
+		}
+		// not in the cyclotomic subgroup
+		CYBOZU_TEST_ASSERT(!x.isValidOrder());
+		// in the cyclotomic subgroup but not in GT
+		local::mapToCyclotomic(x, x);
+		GT y;
+		GT::pow(y, x, BN::param.r);
+		CYBOZU_TEST_ASSERT(!y.isOne());
+		CYBOZU_TEST_ASSERT(!x.isValidOrder());
+		// the order of y divides (p^4 - p^2 + 1)/r
+		CYBOZU_TEST_ASSERT(!y.isValidOrder());
+		x *= e;
+		CYBOZU_TEST_ASSERT(!x.isValidOrder());
+	}
+	// deserialize
+	uint8_t buf1[1024], buf2[1024];
+	const size_t n = e.serialize(buf1, sizeof(buf1));
+	CYBOZU_TEST_ASSERT(n > 0);
+	CYBOZU_TEST_EQUAL(x.serialize(buf2, sizeof(buf2)), n);
+	verifyOrderGT(true);
+	GT z;
+	CYBOZU_TEST_EQUAL(z.deserialize(buf1, n), n);
+	CYBOZU_TEST_EQUAL(z, e);
+	CYBOZU_TEST_EQUAL(z.deserialize(buf2, n), 0u);
+	verifyOrderGT(false);
+	CYBOZU_TEST_EQUAL(z.deserialize(buf2, n), n);
+	CYBOZU_TEST_EQUAL(z, x);
+	// deserialize compressed GT
+	const size_t cSize = serializeCompressedGT(buf1, sizeof(buf1), e);
+	CYBOZU_TEST_ASSERT(cSize > 0);
+	CYBOZU_TEST_EQUAL(serializeCompressedGT(buf1 + cSize, sizeof(buf1) - cSize, x), cSize);
+	verifyOrderGT(true);
+	CYBOZU_TEST_EQUAL(deserializeCompressedGT(z, buf1, cSize), cSize);
+	CYBOZU_TEST_EQUAL(z, e);
+	CYBOZU_TEST_EQUAL(deserializeCompressedGT(z, buf1 + cSize, cSize), 0u);
+	GT zVec[2];
+	CYBOZU_TEST_EQUAL(deserializeCompressedGTVec(zVec, buf1, cSize, 1), cSize);
+	CYBOZU_TEST_EQUAL(deserializeCompressedGTVec(zVec, buf1, cSize * 2, 2), 0u);
+	verifyOrderGT(false);
+	CYBOZU_TEST_EQUAL(deserializeCompressedGT(z, buf1 + cSize, cSize), cSize);
+	CYBOZU_TEST_EQUAL(z, x);
+	CYBOZU_TEST_EQUAL(deserializeCompressedGTVec(zVec, buf1, cSize * 2, 2), cSize * 2);
+}
+
+void testVerifyPairingEquations(const G1& P, const G2& Q)
+{
+	puts("testVerifyPairingEquations");
+	/*
+		e(S_i, Q) e(-H_i, pub_i) == 1 where S_i = x_i H_i, pub_i = x_i Q (BLS signatures)
+		and e(a P, b Q) e(-ab P, Q) e(P, 0) == 1
+	*/
+	const size_t k = 13;
+	std::vector<G1> Pvec;
+	std::vector<G2> Qvec;
+	std::vector<size_t> nVec;
+	for (size_t i = 0; i < k; i++) {
+		if (i % 4 == 3) {
+			Fr a, b;
+			a.setByCSPRNG();
+			b.setByCSPRNG();
+			Pvec.push_back(P * a);
+			Qvec.push_back(Q * b);
+			Pvec.push_back(-(P * (a * b)));
+			Qvec.push_back(Q);
+			Pvec.push_back(P);
+			Qvec.push_back(G2());
+			Qvec.back().clear();
+			nVec.push_back(3);
+			continue;
+		}
+		char c = char(i);
+		G1 H;
+		hashAndMapToG1(H, &c, 1);
+		Fr x;
+		x.setByCSPRNG();
+		Pvec.push_back(H * x);
+		Qvec.push_back(Q);
+		Pvec.push_back(-H);
+		Qvec.push_back(Q * x);
+		nVec.push_back(2);
+	}
+	bool okVec[k];
+	CYBOZU_TEST_ASSERT(verifyPairingEquations(Pvec.data(), Qvec.data(), nVec.data(), k, okVec));
+	for (size_t i = 0; i < k; i++) {
+		CYBOZU_TEST_ASSERT(okVec[i]);
+	}
+	CYBOZU_TEST_ASSERT(verifyPairingEquations(Pvec.data(), Qvec.data(), nVec.data(), k, 0, 64));
+	CYBOZU_TEST_ASSERT(verifyPairingEquations(Pvec.data(), Qvec.data(), nVec.data(), 0));
+	// break some equations
+	const size_t badTbl[] = { 0, 5, 7, 12 };
+	size_t pos = 0;
+	size_t badIdx = 0;
+	for (size_t i = 0; i < k; i++) {
+		if (badIdx < CYBOZU_NUM_OF_ARRAY(badTbl) && badTbl[badIdx] == i) {
+			Pvec[pos] += P;
+			badIdx++;
+		}
+		pos += nVec[i];
+	}
+	CYBOZU_TEST_ASSERT(!verifyPairingEquations(Pvec.data(), Qvec.data(), nVec.data(), k));
+	CYBOZU_TEST_ASSERT(!verifyPairingEquations(Pvec.data(), Qvec.data(), nVec.data(), k, okVec));
+	badIdx = 0;
+	for (size_t i = 0; i < k; i++) {
+		const bool isBad = badIdx < CYBOZU_NUM_OF_ARRAY(badTbl) && badTbl[badIdx] == i;
+		CYBOZU_TEST_EQUAL(okVec[i], !isBad);
+		if (isBad) badIdx++;
+	}
+	CYBOZU_TEST_ASSERT(!verifyPairingEquations(Pvec.data(), Qvec.data(), nVec.data(), 1, okVec));
+	CYBOZU_TEST_ASSERT(!okVec[0]);
+	CYBOZU_TEST_ASSERT(verifyPairingEquations(Pvec.data() + 2, Qvec.data() + 2, nVec.data() + 1, 1, okVec));
+	CYBOZU_TEST_ASSERT(okVec[0]);
+}
+
 void testCommon(const G1& P, const G2& Q)
 {
+	testMillerLoopVecAffine();
+	testPrecomputedMillerLoopVec();
+	testPrecomputedMillerLoopAffine();
+	testFinalExpVec();
+	testCompressedGT(P, Q);
+	testIsValidOrderGT(P, Q);
+	testVerifyPairingEquations(P, Q);
+	testHashAndMapToStream();
 	testMulSmall();
 	testFp2Dbl_mul_xi1();
 	testABCD();
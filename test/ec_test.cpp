@@ -10,6 +10,7 @@
 #include <mcl/ecparam.hpp>
 #include <time.h>
 #include <math.h>
+#include <vector>
 
 typedef mcl::FpT<> Fp;
 struct tagZn;
@@ -71,6 +72,59 @@ void mulVecTest(const mcl::EcParam& para, mcl::ec::Mode ecMode)
 	}
 }
 
+/*
+	check the carry of signed-digit windows in mulVecLong
+	by patterns such as 0xff..ff, 0x7f..ff, 0x80..00
+	equal or negated points are added to the same bucket in mulVecCoreBatchAffine
+*/
+void mulVecLongTest(const mcl::EcParam& para, mcl::ec::Mode ecMode)
+{
+	if (ecMode != mcl::ec::Jacobi) return;
+	puts("mulVecLongTest");
+	cybozu::XorShift rg;
+	const Fp x(para.gx);
+	const Fp y(para.gy);
+	const Ec P(x, y);
+	const size_t N = 1100; // use malloc if n > MCL_MAX_N_TO_USE_STACK_FOR_MUL_VEC
+	const size_t next = Zn::getUnitSize();
+	std::vector<Ec> xVec(N), x0Vec(N);
+	std::vector<mcl::Unit> yVec(N * next);
+	for (size_t i = 0; i < N; i++) {
+		Ec::mul(x0Vec[i], P, (i % 100) + 3);
+		if ((i % 7) == 0) Ec::neg(x0Vec[i], x0Vec[i]);
+		mcl::Unit *yi = &yVec[i * next];
+		for (size_t j = 0; j < next; j++) {
+			switch (i % 5) {
+			case 0: yi[j] = ~mcl::Unit(0); break;
+			case 1: yi[j] = (j == next - 1) ? (~mcl::Unit(0) >> 1) : ~mcl::Unit(0); break;
+			case 2: yi[j] = (j == next - 1) ? (mcl::Unit(1) << (mcl::UnitBitSize - 1)) : 0; break;
+			case 3: yi[j] = mcl::Unit(0x5555555555555555ull); break;
+			default: yi[j] = mcl::Unit(rg.get64()); break;
+			}
+		}
+	}
+	// sumVec[n] = sum_{j=0}^{n-1} x0Vec[j] * yVec[j]
+	std::vector<Ec> sumVec(N + 1);
+	sumVec[0].clear();
+	for (size_t j = 0; j < N; j++) {
+		Ec T;
+		Ec::mulArray(T, x0Vec[j], &yVec[j * next], next);
+		Ec::add(sumVec[j + 1], sumVec[j], T);
+	}
+	const size_t nTbl[] = { 2, 3, 31, 200, N };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(nTbl); i++) {
+		const size_t n = nTbl[i];
+		const Ec& Q1 = sumVec[n];
+		Ec Q2;
+		xVec = x0Vec;
+		mcl::ec::mulVecLong(Q2, xVec.data(), yVec.data(), next, next, n);
+		CYBOZU_TEST_EQUAL(Q1, Q2);
+		xVec = x0Vec;
+		CYBOZU_TEST_EQUAL(mcl::ec::mulVecCoreBatchAffine(Q2, xVec.data(), yVec.data(), next, next, n), n);
+		CYBOZU_TEST_EQUAL(Q1, Q2);
+	}
+}
+
 
 struct Test {
 	const mcl::EcParam& para;
@@ -640,6 +694,7 @@ mul 499.00usec
 	void run() const
 	{
 		mulVecTest(para, ecMode);
+		mulVecLongTest(para, ecMode);
 		normalizeVecTest();
 		cstr();
 		ope();
@@ -3,6 +3,8 @@
 #include <mcl/conversion.hpp>
 #include <mcl/gmp_util.hpp>
 #include <mcl/fp.hpp>
+#include <cybozu/sha2.hpp>
+#include <cybozu/benchmark.hpp>
 #include <vector>
 
 CYBOZU_TEST_AUTO(arrayToHex)
@@ -281,3 +283,46 @@ CYBOZU_TEST_AUTO(BitIterator)
 		}
 	}
 }
+
+#ifndef CYBOZU_USE_OPENSSL_SHA
+void sha256(uint8_t *md, const std::vector<uint8_t>& v)
+{
+	cybozu::Sha256().digest(md, 32, v.data(), v.size());
+}
+
+CYBOZU_TEST_AUTO(sha256BlockFunc)
+{
+	// mcl::fp::sha256 uses SHA extensions if available
+	const cybozu::sha2_local::Sha256BlockFunc f = cybozu::Sha256::getBlockFunc();
+	printf("sha256 blockFunc %s\n", f ? "native" : "portable");
+	const uint8_t abcMd[] = {
+		0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+		0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+	};
+	uint8_t md[32];
+	CYBOZU_TEST_EQUAL(mcl::fp::sha256(md, sizeof(md), "abc", 3), 32u);
+	CYBOZU_TEST_EQUAL_ARRAY(md, abcMd, sizeof(md));
+	std::vector<uint8_t> v(1000);
+	for (size_t i = 0; i < v.size(); i++) {
+		v[i] = uint8_t(i * 7 + 1);
+	}
+	for (size_t n = 0; n < v.size(); n += 13) {
+		uint8_t md1[32], md2[32];
+		cybozu::Sha256::setBlockFunc(0);
+		cybozu::Sha256().digest(md1, sizeof(md1), v.data(), n);
+		cybozu::Sha256::setBlockFunc(f);
+		cybozu::Sha256 h;
+		// split the message at the position crossing the blocks
+		const size_t n1 = n / 3;
+		h.update(v.data(), n1);
+		h.digest(md2, sizeof(md2), v.data() + n1, n - n1);
+		CYBOZU_TEST_EQUAL_ARRAY(md1, md2, sizeof(md1));
+	}
+#ifdef NDEBUG
+	CYBOZU_BENCH_C("sha256 1000 byte", 10000, sha256, md, v);
+	cybozu::Sha256::setBlockFunc(0);
+	CYBOZU_BENCH_C("sha256 1000 byte portable", 10000, sha256, md, v);
+	cybozu::Sha256::setBlockFunc(f);
+#endif
+}
+#endif
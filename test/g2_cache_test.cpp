@@ -0,0 +1,175 @@
+#include <cybozu/test.hpp>
+#include <mcl/bls12_381.hpp>
+#include <mcl/g2_cache.hpp>
+#ifdef MCL_USE_STD_THREAD
+#include <mcl/thread_pool.hpp>
+#endif
+#include <vector>
+#include <string>
+
+using namespace mcl::bn;
+
+std::string serialize(const G2& Q)
+{
+	uint8_t buf[256];
+	size_t n = Q.serialize(buf, sizeof(buf));
+	CYBOZU_TEST_ASSERT(n > 0);
+	return std::string((const char*)buf, n);
+}
+
+void makeVec(std::vector<G2>& Qvec, std::vector<std::string>& sVec, size_t n)
+{
+	Qvec.resize(n);
+	sVec.resize(n);
+	for (size_t i = 0; i < n; i++) {
+		char c = char(i);
+		hashAndMapToG2(Qvec[i], &c, 1);
+		sVec[i] = serialize(Qvec[i]);
+	}
+}
+
+CYBOZU_TEST_AUTO(deserialize)
+{
+	initPairing(mcl::BLS12_381);
+	const size_t n = 10;
+	std::vector<G2> Qvec;
+	std::vector<std::string> sVec;
+	makeVec(Qvec, sVec, n);
+	G2Cache cache(1024 * 1024);
+	for (int j = 0; j < 2; j++) {
+		for (size_t i = 0; i < n; i++) {
+			G2 Q;
+			CYBOZU_TEST_EQUAL(cache.deserialize(Q, sVec[i].data(), sVec[i].size()), sVec[i].size());
+			CYBOZU_TEST_EQUAL(Q, Qvec[i]);
+		}
+	}
+	CYBOZU_TEST_EQUAL(cache.size(), n);
+	CYBOZU_TEST_EQUAL(cache.getMissNum(), n);
+	CYBOZU_TEST_EQUAL(cache.getHitNum(), n);
+	// bad data
+	std::string s = sVec[0];
+	s[s.size() / 2] ^= 1;
+	G2 Q;
+	CYBOZU_TEST_EQUAL(cache.deserialize(Q, s.data(), s.size()), 0u);
+	CYBOZU_TEST_EQUAL(cache.size(), n);
+	cache.clear();
+	CYBOZU_TEST_EQUAL(cache.size(), 0u);
+	CYBOZU_TEST_EQUAL(cache.getByteSize(), 0u);
+	CYBOZU_TEST_EQUAL(cache.getHitNum(), 0u);
+}
+
+CYBOZU_TEST_AUTO(millerLoop)
+{
+	initPairing(mcl::BLS12_381);
+	const size_t n = 5;
+	std::vector<G2> Qvec;
+	std::vector<std::string> sVec;
+	makeVec(Qvec, sVec, n);
+	G1 P;
+	hashAndMapToG1(P, "abc", 3);
+	G2Cache cache(1024 * 1024);
+	for (int j = 0; j < 2; j++) {
+		for (size_t i = 0; i < n; i++) {
+			Fp12 e1, e2;
+			millerLoop(e1, P, Qvec[i]);
+			CYBOZU_TEST_ASSERT(cache.millerLoop(e2, P, sVec[i].data(), sVec[i].size()));
+			CYBOZU_TEST_EQUAL(e1, e2);
+		}
+	}
+	CYBOZU_TEST_EQUAL(cache.getMissNum(), n);
+	CYBOZU_TEST_EQUAL(cache.getHitNum(), n);
+	// Qcoeff is added to the entry made by deserialize
+	cache.clear();
+	G2 Q;
+	Fp12 e1, e2;
+	CYBOZU_TEST_ASSERT(cache.deserialize(Q, sVec[0].data(), sVec[0].size()));
+	CYBOZU_TEST_ASSERT(cache.millerLoop(e1, P, sVec[0].data(), sVec[0].size()));
+	CYBOZU_TEST_ASSERT(cache.millerLoop(e2, P, sVec[0].data(), sVec[0].size()));
+	CYBOZU_TEST_EQUAL(e1, e2);
+	CYBOZU_TEST_EQUAL(cache.getMissNum(), 2u);
+	CYBOZU_TEST_EQUAL(cache.getHitNum(), 1u);
+	CYBOZU_TEST_EQUAL(cache.size(), 1u);
+	// disabled cache
+	G2Cache noCache;
+	CYBOZU_TEST_ASSERT(noCache.millerLoop(e2, P, sVec[0].data(), sVec[0].size()));
+	CYBOZU_TEST_EQUAL(e1, e2);
+	CYBOZU_TEST_EQUAL(noCache.size(), 0u);
+}
+
+CYBOZU_TEST_AUTO(lru)
+{
+	initPairing(mcl::BLS12_381);
+	const size_t n = 10;
+	std::vector<G2> Qvec;
+	std::vector<std::string> sVec;
+	makeVec(Qvec, sVec, n);
+	G2Cache cache(1024 * 1024);
+	G2 Q;
+	cache.deserialize(Q, sVec[0].data(), sVec[0].size());
+	const size_t entrySize = cache.getByteSize();
+	// room for 3 entries
+	cache.setMaxByte(entrySize * 3);
+	for (size_t i = 1; i < n; i++) {
+		cache.deserialize(Q, sVec[i].data(), sVec[i].size());
+		// keep sVec[0] recently used
+		cache.deserialize(Q, sVec[0].data(), sVec[0].size());
+		CYBOZU_TEST_ASSERT(cache.size() <= 3);
+		CYBOZU_TEST_ASSERT(cache.getByteSize() <= entrySize * 3);
+	}
+	const uint64_t hitNum = cache.getHitNum();
+	cache.deserialize(Q, sVec[0].data(), sVec[0].size());
+	CYBOZU_TEST_EQUAL(cache.getHitNum(), hitNum + 1);
+	cache.deserialize(Q, sVec[n - 1].data(), sVec[n - 1].size());
+	CYBOZU_TEST_EQUAL(cache.getHitNum(), hitNum + 2);
+	cache.deserialize(Q, sVec[1].data(), sVec[1].size());
+	CYBOZU_TEST_EQUAL(cache.getHitNum(), hitNum + 2);
+	cache.setMaxByte(0);
+	CYBOZU_TEST_EQUAL(cache.size(), 0u);
+}
+
+#ifdef MCL_USE_STD_THREAD
+CYBOZU_TEST_AUTO(multiThread)
+{
+	initPairing(mcl::BLS12_381);
+	const size_t n = 8;
+	std::vector<G2> Qvec;
+	std::vector<std::string> sVec;
+	makeVec(Qvec, sVec, n);
+	G1 P;
+	hashAndMapToG1(P, "abc", 3);
+	std::vector<Fp12> eVec(n);
+	for (size_t i = 0; i < n; i++) {
+		millerLoop(eVec[i], P, Qvec[i]);
+	}
+	G2Cache cache(1024 * 1024);
+	mcl::ThreadPool pool(4);
+	const size_t m = 64;
+	std::vector<int> ok(m);
+	pool.run(m, [&](size_t i) {
+		const size_t j = i % n;
+		Fp12 e;
+		ok[i] = cache.millerLoop(e, P, sVec[j].data(), sVec[j].size()) && e == eVec[j];
+	});
+	for (size_t i = 0; i < m; i++) {
+		CYBOZU_TEST_ASSERT(ok[i]);
+	}
+	CYBOZU_TEST_EQUAL(cache.size(), n);
+	CYBOZU_TEST_EQUAL(cache.getHitNum() + cache.getMissNum(), m);
+}
+#endif
+
+CYBOZU_TEST_AUTO(changeCurve)
+{
+	initPairing(mcl::BLS12_381);
+	std::vector<G2> Qvec;
+	std::vector<std::string> sVec;
+	makeVec(Qvec, sVec, 1);
+	G2Cache cache(1024 * 1024);
+	G2 Q;
+	CYBOZU_TEST_ASSERT(cache.deserialize(Q, sVec[0].data(), sVec[0].size()));
+	CYBOZU_TEST_EQUAL(cache.size(), 1u);
+	initPairing(mcl::BN254);
+	cache.deserialize(Q, sVec[0].data(), sVec[0].size());
+	CYBOZU_TEST_EQUAL(cache.getHitNum(), 0u);
+	initPairing(mcl::BLS12_381);
+}
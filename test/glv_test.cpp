@@ -101,6 +101,69 @@ void testGLV(const G& P, const char *name)
 	}
 }
 
+template<class GLV>
+void splitMpz(mpz_class *u, const Fr& x)
+{
+	mpz_class mx = x.getMpz();
+	GLV::split(u, mx);
+}
+
+/*
+	check sum_j u[j] lambda^j P = x P for the fixed-width split
+	and |u[j]| is not larger than the one by mpz_class
+*/
+template<class GLV, class G>
+void testSplitUnit(const G& P, const char *name)
+{
+	printf("testSplitUnit %s\n", name);
+	const int splitN = GLV::splitN;
+	const size_t n = Fr::getUnitSize();
+	G L[splitN];
+	L[0] = P;
+	for (int j = 1; j < splitN; j++) {
+		GLV::mulLambda(L[j], L[j - 1]);
+	}
+	cybozu::XorShift rg;
+	for (int i = 0; i < 100; i++) {
+		Fr x;
+		switch (i) {
+		case 0: x = 0; break;
+		case 1: x = 1; break;
+		case 2: x = -1; break;
+		default: x.setByCSPRNG(rg); break;
+		}
+		mcl::Unit xu[Fr::maxSize], u[splitN][Fr::maxSize];
+		bool neg[splitN];
+		x.getUnitArray(xu);
+		GLV::split(u[0], Fr::maxSize, neg, xu);
+		mpz_class mx = x.getMpz(), mu[splitN];
+		GLV::split(mu, mx);
+		G Q1, Q2, T;
+		G::mulGeneric(Q1, P, x.getMpz());
+		Q2.clear();
+		for (int j = 0; j < splitN; j++) {
+			mpz_class t;
+			mcl::gmp::setArray(t, u[j], n);
+			if (mu[j] < 0) mu[j] = -mu[j];
+			CYBOZU_TEST_ASSERT(mcl::gmp::getBitSize(t) <= mcl::gmp::getBitSize(mu[j]) + 1);
+			G::mulGeneric(T, L[j], t);
+			if (neg[j]) G::neg(T, T);
+			Q2 += T;
+		}
+		CYBOZU_TEST_EQUAL(Q1, Q2);
+	}
+#ifdef NDEBUG
+	mcl::Unit xu[Fr::maxSize], u[splitN][Fr::maxSize];
+	bool neg[splitN];
+	Fr x;
+	x.setByCSPRNG(rg);
+	x.getUnitArray(xu);
+	mpz_class mu[splitN];
+	CYBOZU_BENCH_C("split mpz ", 10000, splitMpz<GLV>, mu, x);
+	CYBOZU_BENCH_C("split Unit", 10000, GLV::split, u[0], Fr::maxSize, neg, xu);
+#endif
+}
+
 template<class G>
 void naiveMulVec(G& out, const G *xVec, const Fr *yVec, size_t n)
 {
@@ -156,6 +219,196 @@ void testMulVec(const G& P, const char *name)
 	}
 }
 
+/*
+	compare mulVecCoreBatchAffine with mulVecCore (the current mulVecLong path)
+*/
+template<class G>
+void testMulVecBatchAffine(const G& P, const char *name)
+{
+	printf("testMulVecBatchAffine %s\n", name);
+	const size_t n = 1 << 14;
+	const size_t next = Fr::getUnitSize();
+	std::vector<G> xVec(n);
+	std::vector<mcl::Unit> yVec(n * next);
+	cybozu::XorShift rg;
+	xVec[0] = P;
+	for (size_t i = 1; i < n; i++) {
+		G::add(xVec[i], xVec[i - 1], P);
+	}
+	G::normalizeVec(xVec.data(), xVec.data(), n);
+	for (size_t i = 0; i < n; i++) {
+		Fr y;
+		y.setByCSPRNG(rg);
+		y.getUnitArray(&yVec[i * next]);
+	}
+	G Q1, Q2;
+	CYBOZU_TEST_EQUAL(mcl::ec::mulVecCore(Q1, xVec.data(), yVec.data(), next, next, n, false), n);
+	CYBOZU_TEST_EQUAL(mcl::ec::mulVecCoreBatchAffine(Q2, xVec.data(), yVec.data(), next, next, n, false), n);
+	CYBOZU_TEST_EQUAL(Q1, Q2);
+#ifdef NDEBUG
+	printf("n=%zd\n", n);
+	const int C = 3;
+	CYBOZU_BENCH_C("mulVecCore           ", C, mcl::ec::mulVecCore<G>, Q1, xVec.data(), yVec.data(), next, next, n, false);
+	CYBOZU_BENCH_C("mulVecCoreBatchAffine", C, mcl::ec::mulVecCoreBatchAffine<G>, Q2, xVec.data(), yVec.data(), next, next, n, false);
+#endif
+}
+
+template<class G>
+void testMulVecPrecomputed(const G& P, const char *name)
+{
+	printf("testMulVecPrecomputed %s\n", name);
+	const size_t N = 300;
+	std::vector<G> xVec(N);
+	std::vector<Fr> yVec(N);
+	cybozu::XorShift rg;
+	for (size_t i = 0; i < N; i++) {
+		G::mul(xVec[i], P, i + 3);
+		yVec[i].setByCSPRNG(rg);
+	}
+	yVec[1] = 0;
+	yVec[2] = -1;
+	const size_t bitSize = Fr::getBitSize();
+	const size_t nTbl[] = { 1, 2, 17, N };
+	const size_t stepTbl[] = { 1, 2, 5 };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(stepTbl); i++) {
+		mcl::ec::MulVecTable<G> tbl;
+		tbl.init(xVec.data(), N, bitSize, stepTbl[i]);
+		CYBOZU_TEST_EQUAL(tbl.size(), N);
+		for (size_t j = 0; j < CYBOZU_NUM_OF_ARRAY(nTbl); j++) {
+			const size_t n = nTbl[j];
+			G Q1, Q2;
+			G::mulVec(Q1, std::vector<G>(xVec).data(), yVec.data(), n);
+			G::mulVecPrecomputed(Q2, tbl, yVec.data(), n);
+			CYBOZU_TEST_EQUAL(Q1, Q2);
+		}
+		std::string s;
+		{
+			cybozu::StringOutputStream os(s);
+			tbl.save(os);
+		}
+		mcl::ec::MulVecTable<G> tbl2;
+		{
+			cybozu::StringInputStream is(s);
+			tbl2.load(is);
+		}
+		CYBOZU_TEST_EQUAL(tbl2.getWindowSize(), tbl.getWindowSize());
+		CYBOZU_TEST_EQUAL(tbl2.getStep(), tbl.getStep());
+		G Q1, Q2;
+		G::mulVecPrecomputed(Q1, tbl, yVec.data(), N);
+		G::mulVecPrecomputed(Q2, tbl2, yVec.data(), N);
+		CYBOZU_TEST_EQUAL(Q1, Q2);
+		s.resize(s.size() - 1);
+		{
+			cybozu::StringInputStream is(s);
+			CYBOZU_TEST_EXCEPTION(tbl2.load(is), cybozu::Exception);
+		}
+		// tbl2 is not changed by the failed load
+		s[0]++; // n = N + 1
+		{
+			cybozu::StringInputStream is(s);
+			CYBOZU_TEST_EXCEPTION(tbl2.load(is), cybozu::Exception);
+		}
+		CYBOZU_TEST_EQUAL(tbl2.size(), N);
+		CYBOZU_TEST_EQUAL(tbl2.getTableSize(), tbl.getTableSize());
+		G::mulVecPrecomputed(Q2, tbl2, yVec.data(), N);
+		CYBOZU_TEST_EQUAL(Q1, Q2);
+	}
+	{
+		mcl::ec::MulVecTable<G> tbl;
+		tbl.init(xVec.data(), N, bitSize);
+		G Q;
+		CYBOZU_TEST_EXCEPTION(G::mulVecPrecomputed(Q, tbl, yVec.data(), N + 1), cybozu::Exception);
+	}
+#ifdef NDEBUG
+	const size_t n = 1 << 12;
+	std::vector<G> x0Vec(n), x1Vec(n);
+	std::vector<Fr> y0Vec(n);
+	for (size_t i = 0; i < n; i++) {
+		G::mul(x0Vec[i], P, i + 3);
+		y0Vec[i].setByCSPRNG(rg);
+	}
+	printf("n=%zd\n", n);
+	const int C = 10;
+	G Q;
+	CYBOZU_BENCH_C("mulVecCopy          ", C, mulVecCopy, Q, x1Vec.data(), y0Vec.data(), n, x0Vec.data());
+	for (size_t step = 1; step <= 4; step *= 2) {
+		mcl::ec::MulVecTable<G> tbl;
+		tbl.init(x0Vec.data(), n, bitSize, step);
+		printf("step=%zd c=%zd tblSize=%zd\n", tbl.getStep(), tbl.getWindowSize(), tbl.getTableSize());
+		CYBOZU_BENCH_C("mulVecPrecomputed   ", C, G::mulVecPrecomputed, Q, tbl, y0Vec.data(), n);
+	}
+#endif
+}
+
+template<class G>
+void testMulVecStream(const G& P, const char *name)
+{
+	printf("testMulVecStream %s\n", name);
+	const size_t N = 1000;
+	std::vector<G> xVec(N);
+	std::vector<Fr> yVec(N);
+	cybozu::XorShift rg;
+	for (size_t i = 0; i < N; i++) {
+		G::mul(xVec[i], P, i + 3);
+		yVec[i].setByCSPRNG(rg);
+	}
+	const struct {
+		size_t n; // num of pairs
+		size_t estN; // estimated n
+		size_t chunkN;
+		size_t c;
+	} tbl[] = {
+		{ 0, 10, 7, 0 },
+		{ 1, 1, 7, 0 },
+		{ 10, 10, 3, 0 },
+		{ 100, 100, 100, 0 },
+		{ N, N, 64, 0 },
+		{ N, N, 333, 5 },
+		{ N, 1 << 20, 256, 8 }, // batch affine
+	};
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(tbl); i++) {
+		const size_t n = tbl[i].n;
+		G Q1, Q2;
+		G::mulVec(Q1, xVec.data(), yVec.data(), n);
+		mcl::ec::MulVecArrayReader<G, Fr> reader(xVec.data(), yVec.data(), n);
+		CYBOZU_TEST_ASSERT((mcl::ec::mulVecStream<G, Fr>(Q2, reader, tbl[i].estN, tbl[i].chunkN, tbl[i].c)));
+		CYBOZU_TEST_EQUAL(Q1, Q2);
+	}
+}
+
+template<class GLV, class G>
+void testMulVecGLVstream(const G& P, const char *name)
+{
+	printf("testMulVecGLVstream %s\n", name);
+	const size_t N = 1000;
+	std::vector<G> xVec(N), nVec(N);
+	std::vector<Fr> yVec(N);
+	cybozu::XorShift rg;
+	for (size_t i = 0; i < N; i++) {
+		G::mul(xVec[i], P, i + 3);
+		yVec[i].setByCSPRNG(rg);
+	}
+	yVec[1] = 0;
+	yVec[2] = -1;
+	G::normalizeVec(nVec.data(), xVec.data(), N);
+	const mcl::fp::getUnitAtType getUnitAt = mcl::fp::getUnitAtT<Fr>;
+	const size_t nTbl[] = { 1, 2, 255, 256, 257, N };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(nTbl); i++) {
+		const size_t n = nTbl[i];
+		G Q1, Q2;
+		naiveMulVec(Q1, xVec.data(), yVec.data(), n);
+		CYBOZU_TEST_ASSERT((mcl::ec::mulVecGLVstream<GLV, G>(Q2, xVec.data(), yVec.data(), n, getUnitAt)));
+		CYBOZU_TEST_EQUAL(Q1, Q2);
+		CYBOZU_TEST_ASSERT((mcl::ec::mulVecGLVstream<GLV, G>(Q2, nVec.data(), yVec.data(), n, getUnitAt, true)));
+		CYBOZU_TEST_EQUAL(Q1, Q2);
+	}
+#ifdef NDEBUG
+	G Q;
+	CYBOZU_BENCH_C("mulVecGLVlarge ", 10, (mcl::ec::mulVecGLVlarge<GLV, G>), Q, xVec.data(), yVec.data(), N, getUnitAt, false);
+	CYBOZU_BENCH_C("mulVecGLVstream", 10, (mcl::ec::mulVecGLVstream<GLV, G>), Q, xVec.data(), yVec.data(), N, getUnitAt, false);
+#endif
+}
+
 void naivePowVec(GT& out, const GT *xVec, const Fr *yVec, size_t n)
 {
 	if (n == 1) {
@@ -248,9 +501,19 @@ CYBOZU_TEST_AUTO(glv)
 		pairing(e, P, Q);
 		testGLV(P, "G1");
 		testGLV(Q, "G2");
+		testSplitUnit<local::GLV1>(P, "G1");
+		testSplitUnit<local::GLV2>(Q, "G2");
 		testGT(e);
 		testMulVec(P, "G1");
 		testMulVec(Q, "G2");
+		testMulVecBatchAffine(P, "G1");
+		testMulVecBatchAffine(Q, "G2");
+		testMulVecPrecomputed(P, "G1");
+		testMulVecPrecomputed(Q, "G2");
+		testMulVecStream(P, "G1");
+		testMulVecStream(Q, "G2");
+		testMulVecGLVstream<local::GLV1>(P, "G1");
+		testMulVecGLVstream<local::GLV2>(Q, "G2");
 		testPowVec(e);
 	}
 }
@@ -853,6 +853,167 @@ void testSameUV(const T& mapto)
 	}
 }
 
+void expand_message_xmdLoop(uint8_t *outVec, size_t outSize, const void *const *msgVec, const size_t *msgSizeVec, size_t n, const void *dst, size_t dstSize)
+{
+	for (size_t i = 0; i < n; i++) {
+		mcl::fp::expand_message_xmd(outVec + outSize * i, outSize, msgVec[i], msgSizeVec[i], dst, dstSize);
+	}
+}
+
+void testExpandMessageXmdVec()
+{
+	const size_t n = 37;
+	std::string msgTbl[n];
+	const void *msgVec[n];
+	size_t msgSizeVec[n];
+	for (size_t i = 0; i < n; i++) {
+		// cross the boundaries of 64-byte blocks
+		msgTbl[i] = std::string(i * 7, char('a' + i % 26));
+		msgVec[i] = msgTbl[i].data();
+		msgSizeVec[i] = msgTbl[i].size();
+	}
+	const std::string largeDst(300, 'd');
+	const std::string dstTbl[] = { "", "QUUX-V01-CS02-with-BLS12381G2_XMD:SHA-256_SSWU_RO_", std::string(255, 'd'), largeDst };
+	const size_t outSizeTbl[] = { 32, 128, 256 };
+	const size_t mTbl[] = { 0, 1, 7, 8, 9, 16, 17, n };
+	uint8_t out1[n * 256], out2[n * 256];
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(dstTbl); i++) {
+		const std::string& dst = dstTbl[i];
+		for (size_t j = 0; j < CYBOZU_NUM_OF_ARRAY(outSizeTbl); j++) {
+			const size_t outSize = outSizeTbl[j];
+			expand_message_xmdLoop(out1, outSize, msgVec, msgSizeVec, n, dst.data(), dst.size());
+			for (size_t k = 0; k < CYBOZU_NUM_OF_ARRAY(mTbl); k++) {
+				const size_t m = mTbl[k];
+				memset(out2, 0, sizeof(out2));
+				mcl::fp::expand_message_xmdVec(out2, outSize, msgVec, msgSizeVec, m, dst.data(), dst.size());
+				CYBOZU_TEST_EQUAL_ARRAY(out1, out2, outSize * m);
+			}
+		}
+	}
+#ifndef NDEBUG
+	puts("skip bench of expand_message_xmdVec in debug");
+	return;
+#endif
+	const char *dst = "QUUX-V01-CS02-with-BLS12381G2_XMD:SHA-256_SSWU_RO_";
+	const size_t dstSize = strlen(dst);
+	CYBOZU_BENCH_C("expand_message_xmd x 37", 1000, expand_message_xmdLoop, out1, 256, msgVec, msgSizeVec, n, dst, dstSize);
+	CYBOZU_BENCH_C("expand_message_xmdVec 37", 1000, mcl::fp::expand_message_xmdVec, out2, 256, msgVec, msgSizeVec, n, dst, dstSize);
+}
+
+void hashAndMapToG1Loop(G1 *Pvec, const void *const *msgVec, const size_t *msgSizeVec, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		hashAndMapToG1(Pvec[i], msgVec[i], msgSizeVec[i]);
+		Pvec[i].normalize();
+	}
+}
+
+template<class T>
+void testMsgToG1Vec(const T& mapto)
+{
+	{
+		G1 P, Q1, Q2;
+		hashAndMapToG1(P, "abc", 3);
+		P += P; // not normalized
+		G1::mulGeneric(Q1, P, mapto.g1cofactor);
+		mcl::local::mulByCofactorBLS12fast(Q2, P);
+		CYBOZU_TEST_EQUAL(Q1, Q2);
+	}
+	const size_t n = 40;
+	std::string msgTbl[n];
+	const void *msgVec[n];
+	size_t msgSizeVec[n];
+	for (size_t i = 0; i < n; i++) {
+		msgTbl[i] = std::string(i, 'x') + "msg";
+		msgVec[i] = msgTbl[i].data();
+		msgSizeVec[i] = msgTbl[i].size();
+	}
+	G1 Pvec1[n], Pvec2[n];
+	for (size_t i = 0; i < n; i++) {
+		hashAndMapToG1(Pvec1[i], msgVec[i], msgSizeVec[i]);
+	}
+	const size_t mTbl[] = { 0, 1, 15, 16, 17, n };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(mTbl); i++) {
+		const size_t m = mTbl[i];
+		hashAndMapToG1Vec(Pvec2, msgVec, msgSizeVec, m);
+		for (size_t j = 0; j < m; j++) {
+			CYBOZU_TEST_EQUAL(Pvec1[j], Pvec2[j]);
+			CYBOZU_TEST_ASSERT(Pvec2[j].isNormalized());
+		}
+		hashAndMapToG1VecMT(Pvec2, msgVec, msgSizeVec, m);
+		for (size_t j = 0; j < m; j++) {
+			CYBOZU_TEST_EQUAL(Pvec1[j], Pvec2[j]);
+		}
+	}
+	const char *dst = "QUUX-V01-CS02-with-BLS12381G2_XMD:SHA-256_SSWU_RO_";
+	const size_t dstSize = strlen(dst);
+	mapto.msgToG1Vec(Pvec2, msgVec, msgSizeVec, n, dst, dstSize);
+	for (size_t i = 0; i < n; i++) {
+		mapto.msgToG1(Pvec1[i], msgVec[i], msgSizeVec[i], dst, dstSize);
+		CYBOZU_TEST_EQUAL(Pvec1[i], Pvec2[i]);
+	}
+#ifndef NDEBUG
+	puts("skip bench of hashAndMapToG1Vec in debug");
+	return;
+#endif
+	CYBOZU_BENCH_C("hashAndMapToG1 x 40", 10, hashAndMapToG1Loop, Pvec1, msgVec, msgSizeVec, n);
+	CYBOZU_BENCH_C("hashAndMapToG1Vec 40", 10, hashAndMapToG1Vec, Pvec2, msgVec, msgSizeVec, n);
+	CYBOZU_BENCH_C("hashAndMapToG1VecMT 40", 10, hashAndMapToG1VecMT, Pvec2, msgVec, msgSizeVec, n, 0);
+}
+
+void hashAndMapToG2Loop(G2 *Pvec, const void *const *msgVec, const size_t *msgSizeVec, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		hashAndMapToG2(Pvec[i], msgVec[i], msgSizeVec[i]);
+		Pvec[i].normalize();
+	}
+}
+
+template<class T>
+void testMsgToG2Vec(const T& mapto)
+{
+	const size_t n = 40;
+	std::string msgTbl[n];
+	const void *msgVec[n];
+	size_t msgSizeVec[n];
+	for (size_t i = 0; i < n; i++) {
+		msgTbl[i] = std::string(i, 'x') + "msg";
+		msgVec[i] = msgTbl[i].data();
+		msgSizeVec[i] = msgTbl[i].size();
+	}
+	G2 Pvec1[n], Pvec2[n];
+	for (size_t i = 0; i < n; i++) {
+		hashAndMapToG2(Pvec1[i], msgVec[i], msgSizeVec[i]);
+	}
+	const size_t mTbl[] = { 0, 1, 15, 16, 17, n };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(mTbl); i++) {
+		const size_t m = mTbl[i];
+		hashAndMapToG2Vec(Pvec2, msgVec, msgSizeVec, m);
+		for (size_t j = 0; j < m; j++) {
+			CYBOZU_TEST_EQUAL(Pvec1[j], Pvec2[j]);
+			CYBOZU_TEST_ASSERT(Pvec2[j].isNormalized());
+		}
+		hashAndMapToG2VecMT(Pvec2, msgVec, msgSizeVec, m);
+		for (size_t j = 0; j < m; j++) {
+			CYBOZU_TEST_EQUAL(Pvec1[j], Pvec2[j]);
+		}
+	}
+	const char *dst = "QUUX-V01-CS02-with-BLS12381G2_XMD:SHA-256_SSWU_RO_";
+	const size_t dstSize = strlen(dst);
+	mapto.msgToG2Vec(Pvec2, msgVec, msgSizeVec, n, dst, dstSize);
+	for (size_t i = 0; i < n; i++) {
+		mapto.msgToG2(Pvec1[i], msgVec[i], msgSizeVec[i], dst, dstSize);
+		CYBOZU_TEST_EQUAL(Pvec1[i], Pvec2[i]);
+	}
+#ifndef NDEBUG
+	puts("skip bench of hashAndMapToG2Vec in debug");
+	return;
+#endif
+	CYBOZU_BENCH_C("hashAndMapToG2 x 40", 10, hashAndMapToG2Loop, Pvec1, msgVec, msgSizeVec, n);
+	CYBOZU_BENCH_C("hashAndMapToG2Vec 40", 10, hashAndMapToG2Vec, Pvec2, msgVec, msgSizeVec, n);
+	CYBOZU_BENCH_C("hashAndMapToG2VecMT 40", 10, hashAndMapToG2VecMT, Pvec2, msgVec, msgSizeVec, n, 0);
+}
+
 template<class T>
 void testSetDst(const T& mapto)
 {
@@ -871,6 +1032,11 @@ void testSetDst(const T& mapto)
 	ret = setDstG2("def", 1000);
 	CYBOZU_TEST_ASSERT(!ret);
 	CYBOZU_TEST_EQUAL(mapto.dstG2.dst, dst);
+	// the default dst of G2 is used with its own length
+	G2 P1, P2;
+	hashAndMapToG2(P1, "msg", 3);
+	mapto.msgToG2(P2, "msg", 3, dst, strlen(dst));
+	CYBOZU_TEST_EQUAL(P1, P2);
 }
 
 CYBOZU_TEST_AUTO(test)
@@ -888,6 +1054,9 @@ CYBOZU_TEST_AUTO(test)
 	testMsgToG1(mapto);
 	testFpToG1(mapto);
 	testSameUV(mapto);
+	testExpandMessageXmdVec();
+	testMsgToG1Vec(mapto);
+	testMsgToG2Vec(mapto);
 	// this test should be last
 	testSetDst(mapto);
 }
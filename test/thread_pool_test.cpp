@@ -0,0 +1,191 @@
+#include <cybozu/test.hpp>
+#include <cybozu/xorshift.hpp>
+#include <cybozu/benchmark.hpp>
+#include <mcl/thread_pool.hpp>
+#include <mcl/bls12_381.hpp>
+#include <vector>
+#include <stdexcept>
+#include <chrono>
+#ifdef __linux__
+#include <time.h>
+#endif
+
+using namespace mcl::bn;
+
+CYBOZU_TEST_AUTO(run)
+{
+	const size_t threadTbl[] = { 1, 2, 3, 8 };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(threadTbl); i++) {
+		mcl::ThreadPool pool(threadTbl[i]);
+		CYBOZU_TEST_EQUAL(pool.getThreadNum(), threadTbl[i]);
+		for (size_t n = 0; n < 100; n += 7) {
+			std::vector<int> v(n);
+			pool.run(n, [&](size_t j) { v[j] += int(j) + 1; });
+			for (size_t j = 0; j < n; j++) {
+				CYBOZU_TEST_EQUAL(v[j], int(j) + 1);
+			}
+		}
+	}
+}
+
+CYBOZU_TEST_AUTO(nest)
+{
+	mcl::ThreadPool pool(4);
+	const size_t n = 30, m = 20;
+	std::vector<int> v(n * m);
+	pool.run(n, [&](size_t i) {
+		pool.run(m, [&](size_t j) { v[i * m + j] = int(i * j); });
+	});
+	for (size_t i = 0; i < n; i++) {
+		for (size_t j = 0; j < m; j++) {
+			CYBOZU_TEST_EQUAL(v[i * m + j], int(i * j));
+		}
+	}
+}
+
+CYBOZU_TEST_AUTO(init)
+{
+	mcl::ThreadPool pool(2);
+	std::vector<int> v(100);
+	for (size_t threadN = 1; threadN < 6; threadN++) {
+		pool.init(threadN);
+		CYBOZU_TEST_EQUAL(pool.getThreadNum(), threadN);
+		pool.run(v.size(), [&](size_t i) { v[i]++; });
+	}
+	for (size_t i = 0; i < v.size(); i++) {
+		CYBOZU_TEST_EQUAL(v[i], 5);
+	}
+	CYBOZU_TEST_EQUAL(pool.getTaskNum(10, 16, 0), 1u);
+	CYBOZU_TEST_EQUAL(pool.getTaskNum(100, 16, 3), 3u);
+	CYBOZU_TEST_EQUAL(pool.getTaskNum(2, 16, 3), 1u);
+}
+
+CYBOZU_TEST_AUTO(exception)
+{
+	mcl::ThreadPool pool(4);
+	const size_t n = 50;
+	const size_t throwTbl[] = { 0, 1, 17, n - 1 };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(throwTbl); i++) {
+		std::vector<int> v(n);
+		CYBOZU_TEST_EXCEPTION(pool.run(n, [&](size_t j) {
+			if (j == throwTbl[i]) throw std::runtime_error("err");
+			v[j] = 1;
+		}), std::runtime_error);
+		// all the other tasks are done before run() returns
+		for (size_t j = 0; j < n; j++) {
+			CYBOZU_TEST_EQUAL(v[j], j != throwTbl[i]);
+		}
+	}
+	// the pool is still available
+	std::vector<int> v(n);
+	pool.run(n, [&](size_t j) { v[j] = 1; });
+	for (size_t j = 0; j < n; j++) {
+		CYBOZU_TEST_EQUAL(v[j], 1);
+	}
+}
+
+#ifdef __linux__
+CYBOZU_TEST_AUTO(sleep)
+{
+	// the caller of run() sleeps while the other threads run its tasks
+	mcl::ThreadPool pool(4);
+	const std::thread::id caller = std::this_thread::get_id();
+	timespec ts0, ts1;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts0);
+	pool.run(4, [&](size_t i) {
+		// f(0) lets the workers take the other tasks
+		if (i == 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		} else if (std::this_thread::get_id() != caller) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(300));
+		}
+	});
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts1);
+	const double sec = double(ts1.tv_sec - ts0.tv_sec) + double(ts1.tv_nsec - ts0.tv_nsec) * 1e-9;
+	CYBOZU_TEST_ASSERT(sec < 0.1);
+}
+#endif
+
+CYBOZU_TEST_AUTO(mulVecMT)
+{
+	initPairing(mcl::BLS12_381);
+	const size_t n = 1000;
+	std::vector<G1> Pvec(n), P0vec(n);
+	std::vector<G2> Qvec(n), Q0vec(n);
+	std::vector<Fr> xVec(n);
+	cybozu::XorShift rg;
+	char c = 'a';
+	for (size_t i = 0; i < n; i++) {
+		hashAndMapToG1(P0vec[i], &c, 1);
+		hashAndMapToG2(Q0vec[i], &c, 1);
+		xVec[i].setByCSPRNG(rg);
+		c++;
+	}
+	const size_t poolTbl[] = { 1, 3, 0 };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(poolTbl); i++) {
+		mcl::setThreadPoolSize(poolTbl[i]);
+		for (size_t cpuN = 0; cpuN < 5; cpuN++) {
+			const size_t mTbl[] = { 0, 1, 17, 300, n };
+			for (size_t j = 0; j < CYBOZU_NUM_OF_ARRAY(mTbl); j++) {
+				const size_t m = mTbl[j];
+				G1 P1, P2;
+				Pvec = P0vec;
+				G1::mulVec(P1, Pvec.data(), xVec.data(), m);
+				Pvec = P0vec;
+				G1::mulVecMT(P2, Pvec.data(), xVec.data(), m, cpuN);
+				CYBOZU_TEST_EQUAL(P1, P2);
+				G2 Q1, Q2;
+				Qvec = Q0vec;
+				G2::mulVec(Q1, Qvec.data(), xVec.data(), m);
+				Qvec = Q0vec;
+				G2::mulVecMT(Q2, Qvec.data(), xVec.data(), m, cpuN);
+				CYBOZU_TEST_EQUAL(Q1, Q2);
+				if (m > 100) continue;
+				Fp12 e1, e2;
+				millerLoopVec(e1, P0vec.data(), Q0vec.data(), m);
+				millerLoopVecMT(e2, P0vec.data(), Q0vec.data(), m, cpuN);
+				CYBOZU_TEST_EQUAL(e1, e2);
+			}
+		}
+	}
+	// window-split
+	mcl::setThreadPoolSize(3);
+	G1::normalizeVec(P0vec.data(), P0vec.data(), n);
+	G2::normalizeVec(Q0vec.data(), Q0vec.data(), n);
+	const size_t cTbl[] = { 1, 4, 9 };
+	const size_t blockTbl[] = { 1, 2, 5 };
+	for (size_t i = 0; i < CYBOZU_NUM_OF_ARRAY(cTbl); i++) {
+		for (size_t j = 0; j < CYBOZU_NUM_OF_ARRAY(blockTbl); j++) {
+			const size_t m = 100;
+			G1 P1, P2;
+			Pvec = P0vec;
+			G1::mulVec(P1, Pvec.data(), xVec.data(), m);
+			Pvec = P0vec;
+			CYBOZU_TEST_ASSERT(mcl::ec::mulVecWindowMT(P2, Pvec.data(), xVec.data(), m, mcl::getThreadPool(), 0, cTbl[i], blockTbl[j]));
+			CYBOZU_TEST_EQUAL(P1, P2);
+			G2 Q1, Q2;
+			Qvec = Q0vec;
+			G2::mulVec(Q1, Qvec.data(), xVec.data(), m);
+			Qvec = Q0vec;
+			CYBOZU_TEST_ASSERT(mcl::ec::mulVecWindowMT(Q2, Qvec.data(), xVec.data(), m, mcl::getThreadPool(), 0, cTbl[i], blockTbl[j]));
+			CYBOZU_TEST_EQUAL(Q1, Q2);
+		}
+	}
+	{
+		size_t c, blockN;
+		const size_t bitSize = Fr::getOp().bitSize;
+		CYBOZU_TEST_ASSERT(!mcl::ec::estimateMulVecWindowMT(&c, &blockN, 1 << 20, bitSize, 1));
+		CYBOZU_TEST_ASSERT(!mcl::ec::estimateMulVecWindowMT(&c, &blockN, 256, bitSize, 8));
+		CYBOZU_TEST_ASSERT(mcl::ec::estimateMulVecWindowMT(&c, &blockN, 1 << 20, bitSize, 8));
+	}
+#ifdef NDEBUG
+	mcl::setThreadPoolSize(0);
+	printf("threadN=%zd n=%zd\n", mcl::getThreadPool().getThreadNum(), n);
+	G1 P;
+	CYBOZU_BENCH_C("G1::mulVec  ", 10, G1::mulVec, P, Pvec.data(), xVec.data(), n);
+	CYBOZU_BENCH_C("G1::mulVecMT", 10, G1::mulVecMT, P, Pvec.data(), xVec.data(), n, 0);
+	Fp12 e;
+	CYBOZU_BENCH_C("millerLoopVec  ", 10, millerLoopVec, e, P0vec.data(), Q0vec.data(), 100);
+	CYBOZU_BENCH_C("millerLoopVecMT", 10, millerLoopVecMT, e, P0vec.data(), Q0vec.data(), 100, 0);
+#endif
+}